@@ -0,0 +1,164 @@
+#pragma once
+// animation.h
+// - Reusable animation clips (frame rects into one atlas texture, per-frame durations, looping)
+// - Direction sets: one clip per Dir, so walk cycles are data instead of a switch
+// - AnimActors keeps every animated actor in packed arrays; advance() is one pass over all of them
+// - SpriteBatch collects textured quads for all actors and draws them with one draw call
+
+#include <SFML/Graphics.hpp>
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <algorithm>
+#include <numeric>
+
+enum class Dir { Up = 0, Down = 1, Left = 2, Right = 3 };
+
+struct AnimClip {
+    std::vector<sf::IntRect> frames; // rects inside the atlas
+    std::vector<float> durations;    // seconds per frame (same size as frames)
+    bool loop = true;
+};
+
+// one clip per direction, indexed by (int)Dir
+struct DirClips {
+    std::uint16_t clip[4] = { 0, 0, 0, 0 };
+};
+
+struct AnimLibrary {
+    std::vector<AnimClip> clips;
+    std::vector<DirClips> sets;
+
+    std::uint16_t addClip(AnimClip c) {
+        clips.push_back(std::move(c));
+        return (std::uint16_t)(clips.size() - 1);
+    }
+    std::uint16_t addSet(DirClips s) {
+        sets.push_back(s);
+        return (std::uint16_t)(sets.size() - 1);
+    }
+};
+
+// Packs same-sized images into a grid on one texture. rects[i] is where images[i] ended up.
+static bool buildAtlas(const std::vector<sf::Image>& images, sf::Texture& out, std::vector<sf::IntRect>& rects) {
+    if (images.empty()) return false;
+
+    sf::Vector2u cell{ 0, 0 };
+    for (auto& img : images) {
+        cell.x = std::max(cell.x, img.getSize().x);
+        cell.y = std::max(cell.y, img.getSize().y);
+    }
+
+    unsigned cols = 1;
+    while (cols * cols < images.size()) ++cols;
+    unsigned rows = ((unsigned)images.size() + cols - 1) / cols;
+
+    sf::Image atlas({ cols * cell.x, rows * cell.y }, sf::Color::Transparent);
+    rects.clear();
+    for (size_t i = 0; i < images.size(); ++i) {
+        sf::Vector2u at{ (unsigned)(i % cols) * cell.x, (unsigned)(i / cols) * cell.y };
+        if (!atlas.copy(images[i], at)) return false;
+        rects.push_back(sf::IntRect({ (int)at.x, (int)at.y }, { (int)images[i].getSize().x, (int)images[i].getSize().y }));
+    }
+
+    if (!out.loadFromImage(atlas)) return false;
+    out.setSmooth(false);
+    return true;
+}
+
+struct SpriteBatch {
+    const sf::Texture* texture = nullptr;
+    std::vector<sf::Vertex> verts;
+
+    void clear() { verts.clear(); }
+
+    void addQuad(sf::Vector2f center, sf::Vector2f half, const sf::IntRect& tr, sf::Color c) {
+        float l = (float)tr.position.x, t = (float)tr.position.y;
+        float r = l + (float)tr.size.x, b = t + (float)tr.size.y;
+
+        sf::Vertex v0{ { center.x - half.x, center.y - half.y }, c, { l, t } };
+        sf::Vertex v1{ { center.x + half.x, center.y - half.y }, c, { r, t } };
+        sf::Vertex v2{ { center.x - half.x, center.y + half.y }, c, { l, b } };
+        sf::Vertex v3{ { center.x + half.x, center.y + half.y }, c, { r, b } };
+
+        verts.push_back(v0); verts.push_back(v1); verts.push_back(v2);
+        verts.push_back(v1); verts.push_back(v3); verts.push_back(v2);
+    }
+
+    // returns the number of draw calls issued (0 or 1)
+    unsigned draw(sf::RenderTarget& target) const {
+        if (verts.empty()) return 0;
+        sf::RenderStates states(texture);
+        target.draw(verts.data(), verts.size(), sf::PrimitiveType::Triangles, states);
+        return 1;
+    }
+};
+
+struct AnimActors {
+    // packed per-actor state (index = actor id)
+    std::vector<sf::Vector2f> pos;   // center of the drawn quad
+    std::vector<sf::Vector2f> half;  // half extents of the drawn quad
+    std::vector<std::uint16_t> set;  // AnimLibrary::sets index
+    std::vector<std::uint8_t> dir;   // Dir
+    std::vector<std::uint8_t> moving;
+    std::vector<std::uint16_t> frame;
+    std::vector<float> timer;
+    std::vector<sf::Color> tint;
+
+    std::vector<std::uint32_t> order; // draw order scratch (sorted by y)
+
+    size_t size() const { return pos.size(); }
+
+    size_t add(std::uint16_t animSet, sf::Vector2f center, sf::Vector2f halfSize, sf::Color c = sf::Color::White) {
+        pos.push_back(center);
+        half.push_back(halfSize);
+        set.push_back(animSet);
+        dir.push_back((std::uint8_t)Dir::Down);
+        moving.push_back(0);
+        frame.push_back(0);
+        timer.push_back(0.f);
+        tint.push_back(c);
+        return pos.size() - 1;
+    }
+
+    // one pass over every actor: moving actors step through their clip, idle ones rest on frame 0
+    void advance(const AnimLibrary& lib, float dt) {
+        const size_t n = pos.size();
+        for (size_t i = 0; i < n; ++i) {
+            if (!moving[i]) {
+                frame[i] = 0;
+                timer[i] = 0.f;
+                continue;
+            }
+
+            const AnimClip& clip = lib.clips[lib.sets[set[i]].clip[dir[i]]];
+            const std::uint16_t count = (std::uint16_t)clip.frames.size();
+            if (frame[i] >= count) frame[i] = 0;
+
+            timer[i] += dt;
+            while (clip.durations[frame[i]] > 0.f && timer[i] >= clip.durations[frame[i]]) {
+                timer[i] -= clip.durations[frame[i]];
+                if (frame[i] + 1 < count) ++frame[i];
+                else if (clip.loop) frame[i] = 0;
+                else { timer[i] = 0.f; break; }
+            }
+        }
+    }
+
+    // back-to-front by feet position so overlapping actors layer correctly
+    void appendQuads(const AnimLibrary& lib, SpriteBatch& batch) {
+        const size_t n = pos.size();
+        order.resize(n);
+        std::iota(order.begin(), order.end(), 0u);
+        std::sort(order.begin(), order.end(), [&](std::uint32_t a, std::uint32_t b) {
+            return pos[a].y + half[a].y < pos[b].y + half[b].y;
+            });
+
+        for (std::uint32_t i : order) {
+            const AnimClip& clip = lib.clips[lib.sets[set[i]].clip[dir[i]]];
+            const sf::IntRect& tr = clip.frames[std::min<size_t>(frame[i], clip.frames.size() - 1)];
+            batch.addQuad(pos[i], half[i], tr, tint[i]);
+        }
+    }
+};
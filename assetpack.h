@@ -0,0 +1,318 @@
+#pragma once
+// assetpack.h
+// - One indexed archive (assets.pak) instead of ~20 loose files
+// - writeAssetPack(): offline packer, run as `game --pack assets assets.pak`
+// - AssetPack: memory-maps the archive once; get() returns a view straight into the mapping,
+//   ready for loadFromMemory / openFromMemory (no copies, file stays mapped for the whole run)
+//
+// Layout (little endian):
+//   PackHeader
+//   PackEntry[count]      sorted by nameHash
+//   name table            entry names, not null-terminated
+//   data blobs            each aligned to 16 bytes
+//
+// Names are stored relative to the packed folder, lowercase, with '/' separators
+// ("player/w1.png", "music/menu.mp3"). Lookups are normalized the same way.
+// Each entry also carries a hash of its bytes, computed by the packer, so runtime caches can
+// key on content without reading it.
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <vector>
+#include <string>
+#include <string_view>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <filesystem>
+#include <algorithm>
+
+static std::uint64_t fnv1a64(const void* data, size_t size, std::uint64_t h = 1469598103934665603ull) {
+    const unsigned char* p = (const unsigned char*)data;
+    for (size_t i = 0; i < size; ++i) {
+        h ^= p[i];
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+static std::string normalizeAssetName(std::string_view name) {
+    std::string out(name);
+    for (char& c : out) {
+        if (c == '\\') c = '/';
+        else if (c >= 'A' && c <= 'Z') c = (char)(c - 'A' + 'a');
+    }
+    return out;
+}
+
+struct PackHeader {
+    char magic[4] = { 'L', 'T', 'P', 'K' };
+    std::uint32_t version = 2;
+    std::uint32_t count = 0;
+    std::uint32_t nameTableSize = 0;
+};
+
+struct PackEntry {
+    std::uint64_t nameHash = 0;
+    std::uint64_t offset = 0;   // from start of file
+    std::uint64_t size = 0;
+    std::uint64_t dataHash = 0;   // fnv1a64 of the blob
+    std::uint32_t nameOffset = 0; // into name table
+    std::uint32_t nameLen = 0;
+};
+
+struct AssetView {
+    const void* data = nullptr;
+    size_t size = 0;
+    std::uint64_t hash = 0; // content hash from the pack index
+    explicit operator bool() const { return data != nullptr; }
+};
+
+// -----------------------------
+// Read-only memory mapping of a whole file
+// -----------------------------
+class MappedFile {
+public:
+    MappedFile() = default;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    ~MappedFile() { close(); }
+
+    bool open(const std::filesystem::path& path) {
+        close();
+#ifdef _WIN32
+        file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                           FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS, nullptr);
+        if (file == INVALID_HANDLE_VALUE) return false;
+
+        LARGE_INTEGER sz{};
+        if (!GetFileSizeEx(file, &sz) || sz.QuadPart == 0) { close(); return false; }
+        bytes = (size_t)sz.QuadPart;
+
+        mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!mapping) { close(); return false; }
+
+        base = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        if (!base) { close(); return false; }
+#else
+        fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+
+        struct stat st {};
+        if (fstat(fd, &st) != 0 || st.st_size == 0) { close(); return false; }
+        bytes = (size_t)st.st_size;
+
+        void* p = mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p == MAP_FAILED) { close(); return false; }
+        base = p;
+#endif
+        return true;
+    }
+
+    void close() {
+#ifdef _WIN32
+        if (base) UnmapViewOfFile(base);
+        if (mapping) CloseHandle(mapping);
+        if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+        mapping = nullptr;
+        file = INVALID_HANDLE_VALUE;
+#else
+        if (base) munmap(base, bytes);
+        if (fd >= 0) ::close(fd);
+        fd = -1;
+#endif
+        base = nullptr;
+        bytes = 0;
+    }
+
+    const unsigned char* data() const { return (const unsigned char*)base; }
+    size_t size() const { return bytes; }
+
+private:
+#ifdef _WIN32
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = nullptr;
+#else
+    int fd = -1;
+#endif
+    void* base = nullptr;
+    size_t bytes = 0;
+};
+
+// -----------------------------
+// Runtime side
+// -----------------------------
+class AssetPack {
+public:
+    bool open(const std::filesystem::path& path) {
+        if (!file.open(path)) {
+            std::cerr << "ERROR: couldn't open asset pack: " << path.string() << "\n";
+            return false;
+        }
+
+        if (file.size() < sizeof(PackHeader)) return fail(path, "truncated header");
+        std::memcpy(&header, file.data(), sizeof(PackHeader));
+        if (std::memcmp(header.magic, "LTPK", 4) != 0) return fail(path, "bad magic");
+        if (header.version != 2) return fail(path, "unsupported version (repack it)");
+
+        size_t indexEnd = sizeof(PackHeader) + (size_t)header.count * sizeof(PackEntry);
+        if (indexEnd + header.nameTableSize > file.size()) return fail(path, "truncated index");
+
+        entries = (const PackEntry*)(file.data() + sizeof(PackHeader));
+        names = (const char*)(file.data() + indexEnd);
+
+        for (std::uint32_t i = 0; i < header.count; ++i) {
+            const PackEntry& e = entries[i];
+            if (e.offset + e.size > file.size() || (size_t)e.nameOffset + e.nameLen > header.nameTableSize)
+                return fail(path, "entry out of range");
+        }
+        return true;
+    }
+
+    AssetView get(std::string_view name) const {
+        std::string key = normalizeAssetName(name);
+        std::uint64_t h = fnv1a64(key.data(), key.size());
+
+        const PackEntry* end = entries + header.count;
+        const PackEntry* it = std::lower_bound(entries, end, h,
+            [](const PackEntry& e, std::uint64_t v) { return e.nameHash < v; });
+
+        for (; it != end && it->nameHash == h; ++it) {
+            if (std::string_view(names + it->nameOffset, it->nameLen) == key)
+                return { file.data() + it->offset, (size_t)it->size, it->dataHash };
+        }
+        return {};
+    }
+
+    bool contains(std::string_view name) const { return (bool)get(name); }
+
+private:
+    bool fail(const std::filesystem::path& path, const char* why) {
+        std::cerr << "ERROR: bad asset pack " << path.string() << ": " << why << "\n";
+        file.close();
+        entries = nullptr;
+        names = nullptr;
+        header = {};
+        return false;
+    }
+
+    MappedFile file;
+    PackHeader header;
+    const PackEntry* entries = nullptr;
+    const char* names = nullptr;
+};
+
+// -----------------------------
+// Offline packer
+// -----------------------------
+static bool writeAssetPack(const std::filesystem::path& srcDir, const std::filesystem::path& outFile) {
+    namespace fs = std::filesystem;
+
+    std::error_code ec;
+    if (!fs::is_directory(srcDir, ec)) {
+        std::cerr << "ERROR: not a directory: " << srcDir.string() << "\n";
+        return false;
+    }
+
+    struct Item { std::string name; fs::path path; std::uint64_t hash; };
+    std::vector<Item> items;
+    for (auto& de : fs::recursive_directory_iterator(srcDir, ec)) {
+        if (!de.is_regular_file()) continue;
+        std::string name = normalizeAssetName(fs::relative(de.path(), srcDir).generic_string());
+        items.push_back({ name, de.path(), fnv1a64(name.data(), name.size()) });
+    }
+    if (ec) {
+        std::cerr << "ERROR: couldn't scan " << srcDir.string() << ": " << ec.message() << "\n";
+        return false;
+    }
+    std::sort(items.begin(), items.end(), [](const Item& a, const Item& b) {
+        return a.hash != b.hash ? a.hash < b.hash : a.name < b.name;
+        });
+
+    for (size_t i = 1; i < items.size(); ++i) {
+        if (items[i].name == items[i - 1].name) {
+            std::cerr << "ERROR: duplicate asset name (names are case-insensitive): " << items[i].name << "\n";
+            return false;
+        }
+    }
+
+    PackHeader header;
+    header.count = (std::uint32_t)items.size();
+
+    std::string nameTable;
+    std::vector<PackEntry> entries(items.size());
+    for (size_t i = 0; i < items.size(); ++i) {
+        entries[i].nameHash = items[i].hash;
+        entries[i].nameOffset = (std::uint32_t)nameTable.size();
+        entries[i].nameLen = (std::uint32_t)items[i].name.size();
+        nameTable += items[i].name;
+    }
+    header.nameTableSize = (std::uint32_t)nameTable.size();
+
+    auto align16 = [](std::uint64_t v) { return (v + 15) & ~std::uint64_t(15); };
+
+    std::uint64_t offset = align16(sizeof(PackHeader) + entries.size() * sizeof(PackEntry) + nameTable.size());
+    for (size_t i = 0; i < items.size(); ++i) {
+        entries[i].offset = offset;
+        entries[i].size = fs::file_size(items[i].path, ec);
+        if (ec) {
+            std::cerr << "ERROR: couldn't stat " << items[i].path.string() << "\n";
+            return false;
+        }
+        offset = align16(offset + entries[i].size);
+    }
+
+    std::ofstream out(outFile, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        std::cerr << "ERROR: couldn't write " << outFile.string() << "\n";
+        return false;
+    }
+
+    out.write((const char*)&header, sizeof(header));
+    out.write((const char*)entries.data(), (std::streamsize)(entries.size() * sizeof(PackEntry)));
+    out.write(nameTable.data(), (std::streamsize)nameTable.size());
+
+    std::vector<char> buf;
+    for (size_t i = 0; i < items.size(); ++i) {
+        std::uint64_t pos = (std::uint64_t)out.tellp();
+        if (pos < entries[i].offset) {
+            static const char zeros[16] = {};
+            out.write(zeros, (std::streamsize)(entries[i].offset - pos));
+        }
+
+        std::ifstream in(items[i].path, std::ios::binary);
+        buf.resize((size_t)entries[i].size);
+        if (!in.read(buf.data(), (std::streamsize)buf.size())) {
+            std::cerr << "ERROR: couldn't read " << items[i].path.string() << "\n";
+            return false;
+        }
+        out.write(buf.data(), (std::streamsize)buf.size());
+        entries[i].dataHash = fnv1a64(buf.data(), buf.size());
+        std::cout << "  " << items[i].name << " (" << entries[i].size << " bytes)\n";
+    }
+
+    // content hashes are known only now: rewrite the index in place
+    out.seekp((std::streamoff)sizeof(header));
+    out.write((const char*)entries.data(), (std::streamsize)(entries.size() * sizeof(PackEntry)));
+
+    if (!out) {
+        std::cerr << "ERROR: write failed: " << outFile.string() << "\n";
+        return false;
+    }
+    std::cout << "Packed " << items.size() << " files into " << outFile.string() << "\n";
+    return true;
+}
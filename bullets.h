@@ -0,0 +1,361 @@
+#pragma once
+// bullets.h
+// - Bullet kinds are policies (Straight, SineWave, Homing, Accel, Split), not virtual calls or a
+//   per-bullet switch: each kind lives in its own SoA bucket and BulletBucket<Kind> instantiates
+//   that kind's motion loop, so every inner loop is straight float math the compiler can vectorize
+// - Buckets keep x / y / r in separate arrays, which is exactly what firstHeartHit() wants:
+//   the narrowphase runs on each bucket in place, no gather
+// - Culling and expiry (split bursts) happen in a separate compaction pass, outside the hot loop
+// - runBulletBench(): `game --bench-bullets`, update cost per kind against the old AoS Bullet loop
+
+#include <SFML/Graphics.hpp>
+
+#include "narrowphase.h"
+
+#include <array>
+#include <vector>
+#include <cstdint>
+#include <cstdlib>
+#include <cmath>
+#include <cstring>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+
+enum class BulletKind : std::uint8_t { Straight, Sine, Homing, Accel, Split, Count };
+
+static const char* const kBulletKindNames[] = { "straight", "sine", "homing", "accel", "split" };
+
+// what the motion loops may look at besides their own bullets
+struct BulletEnv {
+    sf::Vector2f target;  // soul center (homing)
+    sf::FloatRect bounds; // bullets outside are culled
+};
+
+// sin for the sine kind: parabola approximation, ~0.001 max error, no branches.
+// Only valid for v >= 0 (the argument is a growing time, so the truncation below is a floor).
+static inline float bulletSin(float v) {
+    v -= 6.2831853f * (float)(int)(v * 0.15915494f + 0.5f); // wrap to [-pi, pi)
+    float y = 1.27323954f * v - 0.40528473f * v * std::fabs(v);
+    return 0.225f * (y * std::fabs(y) - y) + y;
+}
+
+// motion loops promise the compiler that no two arrays overlap, so it can vectorize them
+#if defined(_MSC_VER) || defined(__GNUC__)
+#define BULLET_RESTRICT __restrict
+#else
+#define BULLET_RESTRICT
+#endif
+
+// 1/sqrt(v) to ~0.2%, pure arithmetic: std::sqrt keeps an errno path that stops vectorization
+static inline float bulletRsqrt(float v) {
+    std::uint32_t bits;
+    std::memcpy(&bits, &v, sizeof(bits));
+    bits = 0x5f375a86u - (bits >> 1);
+    float y;
+    std::memcpy(&y, &bits, sizeof(y));
+    return y * (1.5f - 0.5f * v * y * y);
+}
+
+class BulletSet;
+
+// -----------------------------
+// Kinds. Each one names its extra per-bullet attributes (kAttrs of them, one array each),
+// the attribute that counts down to expiry (kLife, -1 = never expires) and its motion loop.
+// -----------------------------
+struct Straight {
+    static constexpr BulletKind kKind = BulletKind::Straight;
+    enum { VX, VY, kAttrs };
+    static constexpr int kLife = -1;
+
+    static std::array<float, kAttrs> attrs(sf::Vector2f vel) { return { vel.x, vel.y }; }
+
+    static void step(float* BULLET_RESTRICT x, float* BULLET_RESTRICT y, float* const* a, size_t n, float dt, const BulletEnv&) {
+        const float* BULLET_RESTRICT vx = a[VX];
+        const float* BULLET_RESTRICT vy = a[VY];
+        for (size_t i = 0; i < n; ++i) x[i] += vx[i] * dt;
+        for (size_t i = 0; i < n; ++i) y[i] += vy[i] * dt;
+    }
+};
+
+// falls at a constant speed while swaying around the column it spawned in; the sway is centered
+// so that the bullet starts exactly at spawnX whatever its starting phase
+struct SineWave {
+    static constexpr BulletKind kKind = BulletKind::Sine;
+    enum { BASE, VY, AMP, FREQ, T, kAttrs };
+    static constexpr int kLife = -1;
+
+    static std::array<float, kAttrs> attrs(float spawnX, float vy, float amp, float freq, float phase) {
+        return { spawnX - amp * bulletSin(phase), vy, amp, freq, phase };
+    }
+
+    static void step(float* BULLET_RESTRICT x, float* BULLET_RESTRICT y, float* const* a, size_t n, float dt, const BulletEnv&) {
+        const float* BULLET_RESTRICT base = a[BASE];
+        const float* BULLET_RESTRICT vy = a[VY];
+        const float* BULLET_RESTRICT amp = a[AMP];
+        const float* BULLET_RESTRICT freq = a[FREQ];
+        float* BULLET_RESTRICT t = a[T];
+        for (size_t i = 0; i < n; ++i) t[i] += freq[i] * dt;
+        for (size_t i = 0; i < n; ++i) x[i] = base[i] + amp[i] * bulletSin(t[i]);
+        for (size_t i = 0; i < n; ++i) y[i] += vy[i] * dt;
+    }
+};
+
+// turns toward the soul at a limited rate, then loses its lock and flies straight
+struct Homing {
+    static constexpr BulletKind kKind = BulletKind::Homing;
+    enum { VX, VY, SPEED, TURN, LOCK, kAttrs };
+    static constexpr int kLife = -1;
+
+    static std::array<float, kAttrs> attrs(sf::Vector2f vel, float speed, float turn, float lockTime) {
+        return { vel.x, vel.y, speed, turn, lockTime };
+    }
+
+    static void step(float* BULLET_RESTRICT x, float* BULLET_RESTRICT y, float* const* a, size_t n, float dt, const BulletEnv& env) {
+        float* BULLET_RESTRICT vx = a[VX];
+        float* BULLET_RESTRICT vy = a[VY];
+        const float* BULLET_RESTRICT speed = a[SPEED];
+        const float* BULLET_RESTRICT turn = a[TURN];
+        float* BULLET_RESTRICT lock = a[LOCK];
+        const float tx = env.target.x, ty = env.target.y;
+        for (size_t i = 0; i < n; ++i) {
+            float dx = tx - x[i], dy = ty - y[i];
+            float s = speed[i] * bulletRsqrt(dx * dx + dy * dy + 1e-4f);
+            float k = std::min(1.f, turn[i] * dt);
+            k = lock[i] > 0.f ? k : 0.f; // select, not a branch
+            vx[i] += (dx * s - vx[i]) * k;
+            vy[i] += (dy * s - vy[i]) * k;
+            lock[i] -= dt;
+        }
+        for (size_t i = 0; i < n; ++i) x[i] += vx[i] * dt;
+        for (size_t i = 0; i < n; ++i) y[i] += vy[i] * dt;
+    }
+};
+
+// starts slow and speeds up
+struct Accel {
+    static constexpr BulletKind kKind = BulletKind::Accel;
+    enum { VX, VY, AX, AY, kAttrs };
+    static constexpr int kLife = -1;
+
+    static std::array<float, kAttrs> attrs(sf::Vector2f vel, sf::Vector2f acc) { return { vel.x, vel.y, acc.x, acc.y }; }
+
+    static void step(float* BULLET_RESTRICT x, float* BULLET_RESTRICT y, float* const* a, size_t n, float dt, const BulletEnv&) {
+        float* BULLET_RESTRICT vx = a[VX];
+        float* BULLET_RESTRICT vy = a[VY];
+        const float* BULLET_RESTRICT ax = a[AX];
+        const float* BULLET_RESTRICT ay = a[AY];
+        for (size_t i = 0; i < n; ++i) vx[i] += ax[i] * dt;
+        for (size_t i = 0; i < n; ++i) vy[i] += ay[i] * dt;
+        for (size_t i = 0; i < n; ++i) x[i] += vx[i] * dt;
+        for (size_t i = 0; i < n; ++i) y[i] += vy[i] * dt;
+    }
+};
+
+// flies straight until its fuse runs out, then bursts into a ring of Straight bullets
+struct Split {
+    static constexpr BulletKind kKind = BulletKind::Split;
+    enum { VX, VY, FUSE, PIECES, PIECE_SPEED, kAttrs };
+    static constexpr int kLife = FUSE;
+
+    static std::array<float, kAttrs> attrs(sf::Vector2f vel, float fuse, int pieces, float pieceSpeed) {
+        return { vel.x, vel.y, fuse, (float)pieces, pieceSpeed };
+    }
+
+    static void step(float* BULLET_RESTRICT x, float* BULLET_RESTRICT y, float* const* a, size_t n, float dt, const BulletEnv&) {
+        const float* BULLET_RESTRICT vx = a[VX];
+        const float* BULLET_RESTRICT vy = a[VY];
+        float* BULLET_RESTRICT fuse = a[FUSE];
+        for (size_t i = 0; i < n; ++i) x[i] += vx[i] * dt;
+        for (size_t i = 0; i < n; ++i) y[i] += vy[i] * dt;
+        for (size_t i = 0; i < n; ++i) fuse[i] -= dt;
+    }
+
+    // defined after BulletSet
+    static void expire(sf::Vector2f pos, float r, const float* attrs, BulletSet& set);
+};
+
+// -----------------------------
+// One SoA bucket per kind
+// -----------------------------
+template <class Kind>
+struct BulletBucket {
+    std::vector<float> x, y, r;
+    std::array<std::vector<float>, Kind::kAttrs> attr;
+
+    size_t size() const { return x.size(); }
+    bool empty() const { return x.empty(); }
+
+    void clear() {
+        x.clear(); y.clear(); r.clear();
+        for (auto& v : attr) v.clear();
+    }
+
+    void spawn(sf::Vector2f pos, float radius, const std::array<float, Kind::kAttrs>& a) {
+        x.push_back(pos.x);
+        y.push_back(pos.y);
+        r.push_back(radius);
+        for (int k = 0; k < Kind::kAttrs; ++k) attr[k].push_back(a[k]);
+    }
+
+    void step(float dt, const BulletEnv& env) {
+        if (empty()) return;
+        float* a[Kind::kAttrs];
+        for (int k = 0; k < Kind::kAttrs; ++k) a[k] = attr[k].data();
+        Kind::step(x.data(), y.data(), a, size(), dt, env);
+    }
+
+    // cull bullets outside env.bounds and expire the ones whose life ran out (swap-remove)
+    void compact(const BulletEnv& env, BulletSet& set) {
+        const float l = env.bounds.position.x, t = env.bounds.position.y;
+        const float rgt = l + env.bounds.size.x, btm = t + env.bounds.size.y;
+
+        size_t n = size();
+
+        // most frames nothing dies: find that out with a branch-free pass first
+        int any = 0;
+        for (size_t i = 0; i < n; ++i)
+            any |= (int)(x[i] < l) | (int)(x[i] > rgt) | (int)(y[i] < t) | (int)(y[i] > btm);
+        if constexpr (Kind::kLife >= 0) {
+            const float* life = attr[Kind::kLife].data();
+            for (size_t i = 0; i < n; ++i) any |= (int)(life[i] <= 0.f);
+        }
+        if (!any) return;
+
+        size_t i = 0;
+        while (i < n) {
+            bool dead = x[i] < l || x[i] > rgt || y[i] < t || y[i] > btm;
+            if constexpr (Kind::kLife >= 0) {
+                if (!dead && attr[Kind::kLife][i] <= 0.f) {
+                    float a[Kind::kAttrs];
+                    for (int k = 0; k < Kind::kAttrs; ++k) a[k] = attr[k][i];
+                    Kind::expire({ x[i], y[i] }, r[i], a, set);
+                    dead = true;
+                }
+            }
+            if (!dead) { ++i; continue; }
+
+            --n;
+            x[i] = x[n]; y[i] = y[n]; r[i] = r[n];
+            for (auto& v : attr) v[i] = v[n];
+        }
+
+        x.resize(n); y.resize(n); r.resize(n);
+        for (auto& v : attr) v.resize(n);
+    }
+};
+
+class BulletSet {
+public:
+    BulletBucket<Straight> straight;
+    BulletBucket<SineWave> sine;
+    BulletBucket<Homing> homing;
+    BulletBucket<Accel> accel;
+    BulletBucket<Split> split;
+
+    // calls f(bucket) for every bucket (generic lambda)
+    template <class F> void forEach(F&& f) {
+        f(straight); f(sine); f(homing); f(accel); f(split);
+    }
+
+    void clear() { forEach([](auto& b) { b.clear(); }); }
+
+    size_t size() {
+        size_t n = 0;
+        forEach([&](auto& b) { n += b.size(); });
+        return n;
+    }
+
+    void update(float dt, const BulletEnv& env) {
+        forEach([&](auto& b) { b.step(dt, env); });
+        // split bursts append to `straight` after it was compacted; they spawn inside bounds anyway
+        forEach([&](auto& b) { b.compact(env, *this); });
+    }
+
+    // narrowphase straight on each bucket's arrays
+    bool hitsHeart(const HeartHitbox& heart, sf::Vector2f soulPos) {
+        bool hit = false;
+        forEach([&](auto& b) {
+            if (!hit && !b.empty())
+                hit = firstHeartHit(heart, soulPos, b.x.data(), b.y.data(), b.r.data(), b.size()) >= 0;
+            });
+        return hit;
+    }
+};
+
+inline void Split::expire(sf::Vector2f pos, float r, const float* a, BulletSet& set) {
+    const int pieces = (int)a[PIECES];
+    for (int k = 0; k < pieces; ++k) {
+        float ang = 6.2831853f * (float)k / (float)pieces;
+        sf::Vector2f v = { std::cos(ang) * a[PIECE_SPEED], std::sin(ang) * a[PIECE_SPEED] };
+        set.straight.spawn(pos, r * 0.75f, Straight::attrs(v));
+    }
+}
+
+// -----------------------------
+// Benchmark: update cost per kind vs the old AoS straight-line loop
+// -----------------------------
+static void runBulletBench() {
+    using Clock = std::chrono::steady_clock;
+
+    struct OldBullet {
+        sf::Vector2f pos;
+        sf::Vector2f vel;
+        float r = 6.f;
+        bool alive = true;
+    };
+
+    const BulletEnv env{ { 450.f, 260.f }, sf::FloatRect({ -1e9f, -1e9f }, { 2e9f, 2e9f }) };
+    const float dt = 1.f / 60.f;
+    const int steps = 200;
+
+    auto rnd = [](float lo, float hi) { return lo + (hi - lo) * ((float)rand() / (float)RAND_MAX); };
+
+    std::cout << "bullets: update ns per bullet per frame (" << steps << " frames, no culling)\n";
+    std::cout << std::setw(8) << "bullets" << std::setw(12) << "old AoS";
+    for (const char* name : kBulletKindNames) std::cout << std::setw(12) << name;
+    std::cout << "\n";
+
+    for (size_t count : { 256u, 4096u, 65536u }) {
+        std::cout << std::setw(8) << count;
+
+        // old: vector<Bullet>, pos += vel * dt, then erase(remove_if(!alive))
+        {
+            std::vector<OldBullet> old(count);
+            for (auto& b : old) { b.pos = { rnd(0.f, 900.f), rnd(0.f, 520.f) }; b.vel = { 0.f, rnd(260.f, 400.f) }; }
+            auto t0 = Clock::now();
+            for (int s = 0; s < steps; ++s) {
+                for (auto& b : old) {
+                    b.pos += b.vel * dt;
+                    if (b.pos.y > 1e9f) b.alive = false;
+                }
+                old.erase(std::remove_if(old.begin(), old.end(), [](const OldBullet& b) { return !b.alive; }), old.end());
+            }
+            auto t1 = Clock::now();
+            std::cout << std::setw(12) << std::fixed << std::setprecision(2)
+                      << std::chrono::duration<double, std::nano>(t1 - t0).count() / ((double)steps * count);
+        }
+
+        // every kind on its own, same count (split fuses never run out here)
+        for (int kind = 0; kind < (int)BulletKind::Count; ++kind) {
+            BulletSet set;
+            for (size_t i = 0; i < count; ++i) {
+                sf::Vector2f p = { rnd(0.f, 900.f), rnd(0.f, 520.f) };
+                sf::Vector2f v = { rnd(-40.f, 40.f), rnd(260.f, 400.f) };
+                switch ((BulletKind)kind) {
+                case BulletKind::Straight: set.straight.spawn(p, 6.f, Straight::attrs(v)); break;
+                case BulletKind::Sine: set.sine.spawn(p, 6.f, SineWave::attrs(p.x, v.y, 30.f, 5.f, rnd(0.f, 6.f))); break;
+                case BulletKind::Homing: set.homing.spawn(p, 6.f, Homing::attrs(v, 200.f, 2.f, 1e9f)); break;
+                case BulletKind::Accel: set.accel.spawn(p, 6.f, Accel::attrs(v, { 0.f, 300.f })); break;
+                default: set.split.spawn(p, 6.f, Split::attrs(v, 1e9f, 6, 150.f)); break;
+                }
+            }
+            auto t0 = Clock::now();
+            for (int s = 0; s < steps; ++s) set.update(dt, env);
+            auto t1 = Clock::now();
+            std::cout << std::setw(12) << std::chrono::duration<double, std::nano>(t1 - t0).count() / ((double)steps * count);
+        }
+        std::cout << "\n";
+    }
+}
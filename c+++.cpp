@@ -15,6 +15,20 @@
 #include <cstdlib>
 #include <ctime>
 #include <string>
+#include <iomanip>
+#include <filesystem>
+#include <fstream>
+
+#include "particles.h"
+#include "animation.h"
+#include "assetpack.h"
+#include "narrowphase.h"
+#include "bullets.h"
+#include "telemetry.h"
+#include "texcache.h"
+#include "flowfield.h"
+#include "mixer.h"
+#include "world.h"
 
 using namespace std;
 
@@ -36,12 +50,10 @@ enum class GameMode {
     GameOver
 };
 
-struct Bullet {
-    sf::Vector2f pos;
-    sf::Vector2f vel;
-    float r = 6.f;
-    bool alive = true;
-    void update(float dt) { pos += vel * dt; }
+// same order as GameMode (telemetry CSV)
+static const char* const kModeNames[] = {
+    "Overworld", "EncounterMenu", "SoulFlyIn", "Battle", "AttackTurn",
+    "DamageMsg", "EnemyDefeated", "Victory", "GameOver"
 };
 
 struct PlayerOverworld {
@@ -67,6 +79,13 @@ struct Encounter {
     bool active = true;
 };
 
+// The hand-made room: everything inside its outer walls, plus the encounter.
+// `game --bake-world` stamps it out as the chunked overworld; the game only reads the chunks.
+static void startRoomLayout(vector<sf::FloatRect>& interiorWalls, vector<WorldTrigger>& triggers) {
+    interiorWalls.push_back(sf::FloatRect({ 360.f, 180.f }, { 160.f, 40.f }));
+    triggers.push_back({ sf::FloatRect({ 640.f, 250.f }, { 80.f, 80.f }), TriggerKind::Encounter });
+}
+
 static bool intersects(const sf::FloatRect& a, const sf::FloatRect& b) {
     return a.findIntersection(b).has_value();
 }
@@ -79,47 +98,180 @@ static bool justPressed(sf::Keyboard::Key key, bool& prev) {
     return pressed;
 }
 
-enum class Dir { Up = 0, Down = 1, Left = 2, Right = 3 };
-
-struct WalkAnim {
-    Dir dir = Dir::Down;
-    int frame = 0;          // 0..3
-    float timer = 0.f;
-    float frameTime = 0.10f;
-    bool moving = false;
-};
+static Dir dirFromMove(sf::Vector2f move) {
+    if (fabs(move.x) > fabs(move.y)) return (move.x > 0) ? Dir::Right : Dir::Left;
+    return (move.y > 0) ? Dir::Down : Dir::Up;
+}
 
-static bool loadFrames(vector<sf::Texture>& out, const vector<string>& files) {
+// frames come back already resized to `size` (their on-screen size), via the disk cache
+static bool loadImages(vector<sf::Image>& out, const AssetPack& pack, TextureCache& cache, const vector<string>& files, sf::Vector2u size) {
     out.clear();
     out.resize(files.size());
     for (size_t i = 0; i < files.size(); ++i) {
-        if (!out[i].loadFromFile(files[i])) {
+        if (!loadCachedImage(pack.get(files[i]), { 1.f, 1.f }, size, cache, out[i])) {
             cerr << "ERROR: couldn't load player frame: " << files[i] << "\n";
             return false;
         }
-        out[i].setSmooth(false);
     }
     return true;
 }
 
-int main() {
+// Rasterize every printable ASCII glyph for each (size, bold) the UI uses, so the first
+// DamageMsg / EnemyDefeated / GameOver frame doesn't pay for FreeType + page uploads mid-game.
+// Keep this list in sync with the setTextSize() calls below (sizes are in canvas pixels).
+struct FontUse { unsigned size; bool bold; };
+
+static void prewarmGlyphs(const sf::Font& font, const vector<FontUse>& uses) {
+    for (const FontUse& u : uses) {
+        for (char32_t c = 32; c < 127; ++c) {
+            font.getGlyph(c, u.size, u.bold);
+        }
+    }
+}
+
+// Blit the canvas into the window: largest whole-number scale that fits, centered,
+// black bars around it. Only shrinks (non-integer) when the window is smaller than the canvas.
+static void presentCanvas(sf::RenderWindow& window, const sf::RenderTexture& canvas) {
+    sf::Vector2f ws(window.getSize());
+    sf::Vector2f cs(canvas.getSize());
+
+    float fit = min(ws.x / cs.x, ws.y / cs.y);
+    float scale = (fit >= 1.f) ? floor(fit) : fit;
+
+    sf::Sprite frame(canvas.getTexture());
+    frame.setScale({ scale, scale });
+    frame.setPosition({ floor((ws.x - cs.x * scale) / 2.f), floor((ws.y - cs.y * scale) / 2.f) });
+
+    window.clear(sf::Color::Black);
+    window.draw(frame);
+    window.display();
+}
+
+int main(int argc, char** argv) {
     srand((unsigned)time(nullptr));
 
     const unsigned W = 900;
     const unsigned H = 520;
 
+    // -----------------------------
+    // OFFLINE TOOLS
+    // -----------------------------
+    // game --pack [assetDir] [out.pak]
+    if (argc >= 2 && string(argv[1]) == "--pack") {
+        string src = (argc >= 3) ? argv[2] : "assets";
+        string dst = (argc >= 4) ? argv[3] : "assets.pak";
+        return writeAssetPack(src, dst) ? 0 : 1;
+    }
+    // game --bake-world [dir] [roomsX roomsY]
+    if (argc >= 2 && string(argv[1]) == "--bake-world") {
+        string dir = (argc >= 3) ? argv[2] : "world";
+        int roomsX = (argc >= 5) ? atoi(argv[3]) : 3;
+        int roomsY = (argc >= 5) ? atoi(argv[4]) : 3;
+        vector<sf::FloatRect> interior;
+        vector<WorldTrigger> triggers;
+        startRoomLayout(interior, triggers);
+        return bakeWorld(dir, roomsX, roomsY, { (float)W, (float)H }, interior, triggers) ? 0 : 1;
+    }
+    // game --bench-narrowphase
+    if (argc >= 2 && string(argv[1]) == "--bench-narrowphase") {
+        runNarrowphaseBench();
+        return 0;
+    }
+    // game --bench-bullets
+    if (argc >= 2 && string(argv[1]) == "--bench-bullets") {
+        runBulletBench();
+        return 0;
+    }
+    // game --bench-flowfield
+    if (argc >= 2 && string(argv[1]) == "--bench-flowfield") {
+        runFlowFieldBench();
+        return 0;
+    }
+    // game --decode-telemetry file.bin [out.csv]
+    if (argc >= 3 && string(argv[1]) == "--decode-telemetry") {
+        const int modeCount = (int)(sizeof(kModeNames) / sizeof(kModeNames[0]));
+        const int kindCount = (int)BulletKind::Count;
+        if (argc >= 4) {
+            std::ofstream csv(argv[3]);
+            if (!csv) {
+                std::cerr << "ERROR: couldn't write " << argv[3] << "\n";
+                return 1;
+            }
+            return decodeTelemetry(argv[2], csv, kModeNames, modeCount, kBulletKindNames, kindCount) ? 0 : 1;
+        }
+        return decodeTelemetry(argv[2], std::cout, kModeNames, modeCount, kBulletKindNames, kindCount) ? 0 : 1;
+    }
+    // game --bench-render [frames] [--golden dir]   (runs after loading, see RENDER BENCHMARK)
+    bool benchRender = false;
+    int benchFrames = 300;
+    string goldenDir;
+    if (argc >= 2 && string(argv[1]) == "--bench-render") {
+        benchRender = true;
+        for (int i = 2; i < argc; ++i) {
+            string a = argv[i];
+            if (a == "--golden" && i + 1 < argc) goldenDir = argv[++i];
+            else benchFrames = max(1, atoi(argv[i]));
+        }
+#ifndef _WIN32
+        // bench boxes have no GPU: ask Mesa for its software rasterizer unless told otherwise
+        setenv("LIBGL_ALWAYS_SOFTWARE", "1", 0);
+#endif
+    }
+
+    // -----------------------------
+    // ASSET PACK (one mapped file; every load below reads straight from it)
+    // -----------------------------
+    AssetPack pack;
+    if (!pack.open("assets.pak")) {
+        std::cerr << "Build it with: game --pack assets assets.pak\n";
+        return 1;
+    }
+
+    const char* requiredAssets[] = {
+        "sfx_hpdown.wav", "enemy.jpeg", "font.ttf",
+        "music/menu.mp3", "music/interaction.mp3", "music/battle.mp3",
+        "music/victory.mp3", "music/gameover.mp3",
+        "player/W1.png", "player/W2.png", "player/W3.png", "player/W4.png",
+        "player/D1.png", "player/D2.png", "player/D3.png", "player/D4.png",
+        "player/L1.png", "player/L2.png", "player/L3.png", "player/L4.png",
+        "player/R1.png", "player/R2.png", "player/R3.png", "player/R4.png"
+    };
+    bool packComplete = true;
+    for (const char* name : requiredAssets) {
+        if (!pack.contains(name)) {
+            std::cerr << "ERROR: asset pack is missing " << name << "\n";
+            packComplete = false;
+        }
+    }
+    if (!packComplete) return 1;
+
     sf::RenderWindow window(sf::VideoMode({ W, H }), "Overworld + Battle Turns (SFML)");
+    if (benchRender) window.setVisible(false);
     window.setFramerateLimit(60);
 
+    // Everything is drawn into this low-resolution canvas, one canvas pixel per `pixelSize`
+    // logical units: gameplay still works in W x H coordinates through uiView, but only a quarter
+    // of the pixels get filled. The canvas is then scaled up by a whole number (2x at the default
+    // window size) and letterboxed into the real window. Textures and glyphs are made at their
+    // size in canvas pixels and drawn scaled by pixelSize, so they map 1:1 onto the canvas.
+    const unsigned pixelSize = 2;
+    sf::RenderTexture canvas;
+    if (!canvas.resize({ W / pixelSize, H / pixelSize })) {
+        std::cerr << "ERROR: couldn't create render canvas\n";
+        return 1;
+    }
+    canvas.setSmooth(false);
+    const sf::View uiView(sf::FloatRect({ 0.f, 0.f }, { (float)W, (float)H }));
+    canvas.setView(uiView);
+
     // ===============================
-    // SFX (WAV/OGG recommended for sf::Sound; MP3 is NOT supported by sf::Sound)
+    // AUDIO (one mixer stream for music and every SFX)
     // ===============================
-    sf::SoundBuffer hpDownBuf;
-    if (!hpDownBuf.loadFromFile("assets/sfx_hpdown.wav")) {
-        std::cerr << "ERROR: couldn't load assets/sfx_hpdown.wav\n";
+    AudioMixer mixer;
+    const MixClip* hpDownSfx = mixer.loadClip(pack.get("sfx_hpdown.wav"));
+    if (!hpDownSfx) {
+        std::cerr << "ERROR: couldn't load sfx_hpdown.wav\n";
     }
-    sf::Sound hpDownSfx(hpDownBuf);
-    hpDownSfx.setVolume(70.f);
 
     // -----------------------------
     // GAME STATE
@@ -129,19 +281,55 @@ int main() {
     bool firstMusic = true;
 
     PlayerOverworld p;
-    Encounter encounter{ sf::FloatRect({640.f, 250.f}, {80.f, 80.f}), true };
+    Encounter encounter{ sf::FloatRect(), true }; // trigger comes from the world chunks
+
+    // -----------------------------
+    // WORLD STREAMING (chunks around the player, loaded by a background thread)
+    // -----------------------------
+    ChunkStreamer world;
+    if (!world.open("world", 2u << 20, 2)) {
+        std::cerr << "Build it with: game --bake-world world\n";
+        return 1;
+    }
+    // the first chunks are loaded before the first frame; after that nothing waits on the loader
+    world.setFocus(p.pos + p.size / 2.f);
+    world.waitForFocus();
+    if (world.failedCount() > 0) {
+        std::cerr << "ERROR: world chunks around the start are missing or corrupt. Rebuild with: game --bake-world world\n";
+        return 1;
+    }
 
-    // Overworld walls
+    // overworld walls / triggers of the resident chunks (refreshed whenever the resident set changes)
     vector<sf::FloatRect> walls;
-    const float t = 30.f;
-    walls.push_back(sf::FloatRect({ 0.f, 0.f }, { (float)W, t }));
-    walls.push_back(sf::FloatRect({ 0.f, (float)H - t }, { (float)W, t }));
-    walls.push_back(sf::FloatRect({ 0.f, 0.f }, { t, (float)H }));
-    walls.push_back(sf::FloatRect({ (float)W - t, 0.f }, { t, (float)H }));
-    walls.push_back(sf::FloatRect({ 360.f, 180.f }, { 160.f, 40.f }));
+    vector<WorldTrigger> triggers;
+    bool encounterResident = false;
+
+    // overworld camera: follows the player, clamped to the world (centered if the world is smaller)
+    auto cameraView = [&]() {
+        sf::Vector2f ws = world.worldSize();
+        sf::Vector2f c = p.pos + p.size / 2.f;
+        c.x = ws.x > W ? clampf(c.x, W / 2.f, ws.x - W / 2.f) : ws.x / 2.f;
+        c.y = ws.y > H ? clampf(c.y, H / 2.f, ws.y - H / 2.f) : ws.y / 2.f;
+        return sf::View(c, { (float)W, (float)H });
+        };
+    auto worldToScreen = [&](sf::Vector2f worldPos) {
+        sf::View cam = cameraView();
+        return worldPos - (cam.getCenter() - cam.getSize() / 2.f);
+        };
+
+    // movement is only allowed inside chunks that loaded fine, so nothing walks into a hole
+    auto hitsWorld = [&](const sf::FloatRect& r) {
+        if (!world.isWalkable(r)) return true;
+        for (auto& w : walls) {
+            if (intersects(r, w)) return true;
+        }
+        return false;
+        };
 
     // Battle box
     sf::FloatRect battleBox({ 260.f, 140.f }, { 380.f, 240.f });
+    // where battles draw the enemy sprite (and where its dissolve starts)
+    const sf::Vector2f enemyBattlePos = { leftOf(battleBox) + battleBox.size.x / 2.f, topOf(battleBox) - 90.f };
 
     Soul soul;
     // default soul position (top-left) to center of battle box
@@ -150,7 +338,13 @@ int main() {
         topOf(battleBox) + battleBox.size.y / 2.f - soul.size.y / 2.f
     };
 
-    vector<Bullet> bullets;
+    // spawns, hits, mode changes and frame times -> telemetry/*.bin (started just before the game loop)
+    Telemetry telemetry;
+    sf::Clock sessionClock;
+
+    BulletSet bullets; // one SoA bucket per bullet kind, fed to the heart narrowphase as-is
+    HeartHitbox heartHitbox;
+    heartHitbox.build(soul.size);
     float spawnTimer = 0.f;
     float battleTime = 0.f;
 
@@ -182,47 +376,50 @@ int main() {
     float soulFlyDur = 1.5f; // seconds
 
     // -----------------------------
-    // MUSIC (ONE INSTANCE ONLY)
+    // MUSIC (crossfades between tracks inside the mixer)
     // -----------------------------
-    sf::Music music;
+    const float musicFade = 0.75f; // seconds
     std::string currentTrack;
 
     auto playMusic = [&](const std::string& file, bool loop = true, float volume = 55.f) {
-        if (currentTrack == file && music.getStatus() == sf::SoundSource::Status::Playing)
+        if (currentTrack == file) {
+            // same track across modes: just bring it back to its level (undoes ducking)
+            mixer.setStemGain(0, volume / 100.f, 0.3f);
             return;
+        }
 
-        music.stop();
-
-        if (!music.openFromFile(file)) {
+        if (!mixer.playMusic({ pack.get(file) }, { volume / 100.f }, loop, musicFade)) {
             std::cerr << "ERROR loading music: " << file << "\n";
             currentTrack.clear();
             return;
         }
-
         currentTrack = file;
-
-#if SFML_VERSION_MAJOR >= 3
-        music.setLooping(loop);
-#else
-        music.setLoop(loop);
-#endif
-        music.setVolume(volume);
-        music.play();
         };
 
     // Start music immediately
-    playMusic("assets/music/menu.mp3", true, 55.f);
+    if (!benchRender) {
+        playMusic("music/menu.mp3", true, 55.f);
+        mixer.play();
+    }
+
+    // resized sprites from earlier runs (one file; saved once the sprites below are loaded)
+    TextureCache texCache("cache/textures.bin");
 
     // -----------------------------
     // LOAD ENEMY SPRITE
     // -----------------------------
+    // drawn at 0.25x of the source in logical units; loaded at that size in canvas pixels (cached on
+    // disk) and scaled back up by pixelSize, so one texel is one canvas pixel.
+    // keep the image around: the defeat dissolve samples its pixels
+    const float enemyScale = 0.25f / pixelSize;
+    sf::Image enemyImg;
     sf::Texture enemyTex;
-    if (!enemyTex.loadFromFile("assets/enemy.jpeg")) {
-        std::cerr << "ERROR: couldn't load assets/enemy.jpeg\n";
+    if (!loadCachedTexture(pack.get("enemy.jpeg"), { enemyScale, enemyScale }, { 0, 0 }, false, texCache, enemyTex, &enemyImg)) {
+        std::cerr << "ERROR: couldn't load enemy.jpeg\n";
         return 1;
     }
     sf::Sprite enemySprite(enemyTex);
-    enemySprite.setScale({ 0.25f, 0.25f });
+    enemySprite.setScale({ (float)pixelSize, (float)pixelSize });
 
     // set origin ONCE using local bounds (stable)
     sf::FloatRect lb = enemySprite.getLocalBounds();
@@ -233,16 +430,29 @@ int main() {
     // FONT
     // -----------------------------
     sf::Font font;
-    bool hasFont = font.openFromFile("assets/font.ttf");
+    AssetView fontData = pack.get("font.ttf");
+    bool hasFont = font.openFromMemory(fontData.data, fontData.size);
+    if (hasFont) {
+        prewarmGlyphs(font, {
+            { 8, false }, { 9, false }, { 10, false }, { 11, false },
+            { 14, false }, { 16, false }, { 21, true }, { 24, true }
+            });
+    }
+
+    // glyphs are rasterized at their canvas-pixel size and scaled up to logical units
+    auto setTextSize = [&](sf::Text& t, unsigned canvasPx) {
+        t.setCharacterSize(canvasPx);
+        t.setScale({ (float)pixelSize, (float)pixelSize });
+        };
 
     sf::Text menuTitle(font), optionWalk(font), optionAttack(font), hintText(font);
     sf::Text victoryTitle(font), victoryHint(font);
 
     if (hasFont) {
-        menuTitle.setCharacterSize(22);
-        optionWalk.setCharacterSize(18);
-        optionAttack.setCharacterSize(18);
-        hintText.setCharacterSize(10);
+        setTextSize(menuTitle, 11);
+        setTextSize(optionWalk, 9);
+        setTextSize(optionAttack, 9);
+        setTextSize(hintText, 8);
         hintText.setLineSpacing(1.5f);
 
         menuTitle.setFillColor(sf::Color::White);
@@ -256,49 +466,134 @@ int main() {
         hintText.setString("Use W/S to choose, \n"
             "Enter to confirm, Esc to cancel");
 
-        victoryTitle.setCharacterSize(48);
+        setTextSize(victoryTitle, 24);
         victoryTitle.setFillColor(sf::Color::Yellow);
         victoryTitle.setStyle(sf::Text::Bold);
         victoryTitle.setString("YOU WON!");
 
-        victoryHint.setCharacterSize(20);
+        setTextSize(victoryHint, 10);
         victoryHint.setFillColor(sf::Color(200, 200, 200));
         victoryHint.setString("Press Enter to continue");
     }
 
     // -----------------------------
-    // PLAYER ANIMATED SPRITE (4 dirs x 4 frames)
+    // ANIMATED ACTORS (player + villagers, 4 dirs x 4 frames, one atlas)
     // -----------------------------
-    vector<sf::Texture> framesUp, framesDown, framesLeft, framesRight;
+    // Draw size relative to hitbox, but keep a VISUAL multiplier so it isn't tiny
+    float visualScale = 1.8f; // tweak 1.5f..2.3f
+    sf::Vector2f actorHalf = { p.size.x * visualScale / 2.f, p.size.y * visualScale / 2.f };
+    // atlas frames are made at their size in canvas pixels; the quads stretch them back over actorHalf
+    sf::Vector2u frameSize = { (unsigned)std::lround(actorHalf.x * 2.f / pixelSize), (unsigned)std::lround(actorHalf.y * 2.f / pixelSize) };
+
+    // image order must match Dir: Up, Down, Left, Right
+    vector<sf::Image> walkImages;
+    if (!loadImages(walkImages, pack, texCache, {
+        "player/W1.png","player/W2.png","player/W3.png","player/W4.png",
+        "player/D1.png","player/D2.png","player/D3.png","player/D4.png",
+        "player/L1.png","player/L2.png","player/L3.png","player/L4.png",
+        "player/R1.png","player/R2.png","player/R3.png","player/R4.png" }, frameSize)) return 1;
+
+    sf::Texture actorAtlas;
+    vector<sf::IntRect> walkRects;
+    if (!buildAtlas(walkImages, actorAtlas, walkRects)) {
+        std::cerr << "ERROR: couldn't build actor atlas\n";
+        return 1;
+    }
+    walkImages.clear();
+    texCache.save();
+
+    AnimLibrary anims;
+    DirClips walkClips;
+    for (int d = 0; d < 4; ++d) {
+        AnimClip clip;
+        for (int f = 0; f < 4; ++f) {
+            clip.frames.push_back(walkRects[d * 4 + f]);
+            clip.durations.push_back(0.10f);
+        }
+        walkClips.clip[d] = anims.addClip(clip);
+    }
+    const std::uint16_t walkSet = anims.addSet(walkClips);
 
-    if (!loadFrames(framesUp, { "assets/player/W1.png","assets/player/W2.png","assets/player/W3.png","assets/player/W4.png" })) return 1;
-    if (!loadFrames(framesDown, { "assets/player/D1.png","assets/player/D2.png","assets/player/D3.png","assets/player/D4.png" })) return 1;
-    if (!loadFrames(framesLeft, { "assets/player/L1.png","assets/player/L2.png","assets/player/L3.png","assets/player/L4.png" })) return 1;
-    if (!loadFrames(framesRight, { "assets/player/R1.png","assets/player/R2.png","assets/player/R3.png","assets/player/R4.png" })) return 1;
+    AnimActors actors;
+    SpriteBatch actorBatch;
+    actorBatch.texture = &actorAtlas;
 
-    // SFML 3: must construct sprite with a texture
-    sf::Sprite playerSprite(framesDown[0]);
+    const size_t playerActor = actors.add(walkSet, p.pos + p.size / 2.f, actorHalf);
 
-    // Scale sprite relative to hitbox, but keep a VISUAL multiplier so it isn't tiny
-    auto texSize0 = framesDown[0].getSize();
-    float visualScale = 1.8f; // tweak 1.5f..2.3f
-    playerSprite.setScale({
-        (p.size.x / (float)texSize0.x) * visualScale,
-        (p.size.y / (float)texSize0.y) * visualScale
-        });
-    playerSprite.setOrigin({ texSize0.x / 2.f, texSize0.y / 2.f });
+    // villagers share the walk clips; they wander and turn at random
+    const size_t firstVillager = actors.size();
+    const sf::Vector2f villagerSpawns[] = {
+        { 100.f, 100.f }, { 200.f, 440.f }, { 560.f, 100.f },
+        { 800.f, 440.f }, { 450.f, 330.f }, { 820.f, 100.f }
+    };
+    const sf::Color villagerTints[] = {
+        sf::Color(200, 220, 255), sf::Color(255, 220, 200), sf::Color(210, 255, 210)
+    };
+    vector<sf::Vector2f> villagerVel;
+    vector<float> villagerTurn;
+    for (size_t i = 0; i < size(villagerSpawns); ++i) {
+        actors.add(walkSet, villagerSpawns[i], actorHalf, villagerTints[i % size(villagerTints)]);
+        villagerVel.push_back({ 0.f, 0.f });
+        villagerTurn.push_back(0.f);
+    }
+    const float villagerSpeed = 60.f;
+
+    // -----------------------------
+    // CHASERS (overworld enemies that pursue the player around walls)
+    // -----------------------------
+    // one flow field toward the player is shared by every chaser; it is rebuilt in slices of
+    // chaseBudget cells per frame when the player changes cell, and steering is one lookup each
+    const float chaseCell = 10.f;
+    const size_t chaseBudget = kFlowFieldFrameBudget;
+    FlowField chaseField;
+    // the last published field of the previous grid: chasers keep steering by it after the focus
+    // area moves, until the new grid has published its first field
+    FlowField chasePrevField;
+
+    // the grid covers the chunks around the player; cells in chunks still loading (or that failed to
+    // load) count as walls
+    sf::FloatRect chaseArea;
+    auto chaseCellOpen = [&](sf::Vector2f c) { return world.isWalkable(sf::FloatRect(c, { 0.f, 0.f })); };
+    auto rebuildChaseField = [&]() {
+        if (chaseField.ready()) std::swap(chaseField, chasePrevField);
+        chaseArea = world.focusBounds();
+        chaseField.init(chaseArea.position, { (int)(chaseArea.size.x / chaseCell), (int)(chaseArea.size.y / chaseCell) }, chaseCell);
+        chaseField.refreshBlocked(chaseArea, walls, p.size, chaseCellOpen);
+        };
 
-    WalkAnim walk;
+    // resident chunks changed: new walls / triggers. The field is only re-gridded when the focus
+    // area moved; a chunk arriving inside it just opens its own cells (plus the half-agent margin
+    // its walls reach into neighbors), so the build in progress isn't thrown away
+    auto refreshWorld = [&]() {
+        world.gather(walls, triggers);
+        encounterResident = false;
+        for (const WorldTrigger& tr : triggers) {
+            if (tr.kind != TriggerKind::Encounter) continue;
+            encounter.trigger = tr.rect;
+            encounterResident = true;
+        }
 
-    auto setPlayerFrame = [&]() {
-        int f = std::clamp(walk.frame, 0, 3);
-        switch (walk.dir) {
-        case Dir::Up:    playerSprite.setTexture(framesUp[f], true); break;
-        case Dir::Down:  playerSprite.setTexture(framesDown[f], true); break;
-        case Dir::Left:  playerSprite.setTexture(framesLeft[f], true); break;
-        case Dir::Right: playerSprite.setTexture(framesRight[f], true); break;
+        if (world.focusBounds() != chaseArea) {
+            rebuildChaseField();
+            return;
+        }
+        for (sf::Vector2i c : world.justLoaded()) {
+            sf::FloatRect r = ChunkStreamer::chunkRect(c);
+            r.position -= p.size / 2.f;
+            r.size += p.size;
+            chaseField.refreshBlocked(r, walls, p.size, chaseCellOpen);
         }
         };
+    refreshWorld();
+
+    const sf::Vector2f chaserSpawns[] = { { 60.f, 60.f }, { 840.f, 60.f }, { 840.f, 460.f } };
+    const size_t firstChaser = actors.size();
+    vector<sf::Vector2f> chaserSpawn;
+    for (size_t i = 0; i < size(chaserSpawns); ++i) {
+        actors.add(walkSet, chaserSpawns[i], actorHalf, sf::Color(255, 110, 110));
+        chaserSpawn.push_back(chaserSpawns[i]);
+    }
+    const float chaserSpeed = 95.f;
 
     // -----------------------------
     // RENDERING SHAPES
@@ -368,6 +663,11 @@ int main() {
     sf::RectangleShape enemyHpFill(sf::Vector2f(260.f, 12.f));
     enemyHpFill.setFillColor(sf::Color(220, 80, 80));
 
+    // -----------------------------
+    // PARTICLES (hit sparks, damage burst, defeat dissolve)
+    // -----------------------------
+    ParticlePool particles(8192);
+
     // -----------------------------
     // Input edge states
     // -----------------------------
@@ -401,7 +701,7 @@ int main() {
         soulFlyT = 0.f;
 
         // spawn at player's current overworld position (convert to soul top-left)
-        sf::Vector2f playerCenter = { p.pos.x + p.size.x / 2.f, p.pos.y + p.size.y / 2.f };
+        sf::Vector2f playerCenter = worldToScreen({ p.pos.x + p.size.x / 2.f, p.pos.y + p.size.y / 2.f });
         soulFlyStart = { playerCenter.x - soul.size.x / 2.f, playerCenter.y - soul.size.y / 2.f };
 
         // target = battle box center (soul top-left)
@@ -422,46 +722,453 @@ int main() {
         battleTime = 0.f;
         };
 
+    // -----------------------------
+    // DRAW (one frame of the current mode into the canvas)
+    // -----------------------------
+    unsigned drawCalls = 0; // draw submissions since the last reset (render benchmark)
+    auto draw = [&](const sf::Drawable& d) {
+        ++drawCalls;
+        canvas.draw(d);
+        };
+
     auto drawEnemyAtTrigger = [&]() {
         float ex = encounter.trigger.position.x + encounter.trigger.size.x / 2.f;
         float ey = encounter.trigger.position.y + encounter.trigger.size.y / 2.f;
 
         enemySprite.setPosition({ ex, ey });
-        window.draw(enemySprite);
+        draw(enemySprite);
+        };
+
+    auto drawFrame = [&]() {
+        canvas.clear(sf::Color(10, 10, 12));
+        draw(roomBg);
+
+        // player + villagers in one batched draw
+        auto drawActors = [&]() {
+            actors.pos[playerActor] = {
+                p.pos.x + p.size.x / 2.f,
+                p.pos.y + p.size.y / 2.f
+            };
+            actorBatch.clear();
+            actors.appendQuads(anims, actorBatch);
+            drawCalls += actorBatch.draw(canvas);
+            };
+
+        // world layer through the camera: tiles, walls, (actors), encounter; back to the UI view after
+        auto drawWorld = [&](bool withActors) {
+            sf::View cam = cameraView();
+            sf::FloatRect visible(cam.getCenter() - cam.getSize() / 2.f, cam.getSize());
+            canvas.setView(cam);
+
+            drawCalls += world.draw(canvas, visible);
+            for (auto& w : walls) {
+                if (!w.findIntersection(visible)) continue;
+                wallShape.setPosition(w.position);
+                wallShape.setSize(w.size);
+                draw(wallShape);
+            }
+
+            if (withActors) drawActors();
+
+            if (encounter.active && encounterResident) {
+                triggerOutline.setPosition(encounter.trigger.position);
+                triggerOutline.setSize(encounter.trigger.size);
+                draw(triggerOutline);
+                drawEnemyAtTrigger();
+            }
+            canvas.setView(uiView);
+            };
+
+        auto drawSoulCenteredOnHitbox = [&]() {
+            soulShape.setPosition({
+                soul.pos.x + soul.size.x / 2.f,
+                soul.pos.y + soul.size.y / 2.f
+                });
+            draw(soulShape);
+            };
+
+        if (mode == GameMode::Overworld) {
+            drawWorld(true);
+        }
+        else if (mode == GameMode::EncounterMenu) {
+            drawWorld(true);
+
+            draw(menuPanel);
+
+            sf::Vector2f base = menuPanel.getPosition();
+            sf::Vector2f opt1 = { base.x + 60.f, base.y + 90.f };
+            sf::Vector2f opt2 = { base.x + 60.f, base.y + 135.f };
+
+            sf::Vector2f selPos = (menuIndex == 0)
+                ? sf::Vector2f{ base.x + 35.f, base.y + 98.f }
+            : sf::Vector2f{ base.x + 35.f, base.y + 143.f };
+
+            selector.setPosition(selPos);
+            draw(selector);
+
+            if (hasFont) {
+                menuTitle.setPosition({ base.x + 40.f, base.y + 30.f });
+                optionWalk.setPosition(opt1);
+                optionAttack.setPosition(opt2);
+                hintText.setPosition({ base.x + 40.f, base.y + 175.f });
+
+                optionWalk.setFillColor(menuIndex == 0 ? sf::Color::Yellow : sf::Color::White);
+                optionAttack.setFillColor(menuIndex == 1 ? sf::Color::Yellow : sf::Color::White);
+
+                draw(menuTitle);
+                draw(optionWalk);
+                draw(optionAttack);
+                draw(hintText);
+            }
+        }
+        else if (mode == GameMode::SoulFlyIn) {
+            // show overworld while heart flies in (looks like Undertale transition)
+            drawWorld(false);
+
+            // draw the battle box outline so you see the target
+            draw(boxShape);
+
+            // draw heart flying
+            drawSoulCenteredOnHitbox();
+        }
+        else if (mode == GameMode::Battle) {
+            draw(boxShape);
+
+            sf::CircleShape c;
+            c.setFillColor(sf::Color::White);
+            bullets.forEach([&](auto& bucket) {
+                for (size_t i = 0; i < bucket.size(); ++i) {
+                    c.setRadius(bucket.r[i]);
+                    c.setPosition(sf::Vector2f{ bucket.x[i] - bucket.r[i], bucket.y[i] - bucket.r[i] });
+                    draw(c);
+                }
+                });
+
+            // blink during invuln
+            if (!soul.invuln || fmod(battleTime * 10.f, 2.f) < 1.f) {
+                drawSoulCenteredOnHitbox();
+            }
+
+            float ratio = (float)max(0, soul.hp) / (float)soul.maxHp;
+            hpFill.setSize(sf::Vector2f{ 240.f * ratio, 16.f });
+            draw(hpBack);
+            draw(hpFill);
+
+            // enemy sprite above battle box
+            enemySprite.setPosition(enemyBattlePos);
+            draw(enemySprite);
+
+            float eratio = (float)std::max(0, enemyHp) / (float)enemyMaxHp;
+
+            enemyHpBack.setPosition({
+                leftOf(battleBox) + battleBox.size.x / 2.f - 130.f,
+                topOf(battleBox) - 25.f
+                });
+
+            enemyHpFill.setPosition(enemyHpBack.getPosition());
+            enemyHpFill.setSize({ 260.f * eratio, 12.f });
+
+            draw(enemyHpBack);
+            draw(enemyHpFill);
+        }
+        else if (mode == GameMode::AttackTurn) {
+            sf::RectangleShape overlay(sf::Vector2f((float)W, (float)H));
+            overlay.setFillColor(sf::Color(0, 0, 0, 160));
+            draw(overlay);
+
+            if (hasFont) {
+                sf::Text t(font);
+                setTextSize(t, 14);
+                t.setFillColor(sf::Color::White);
+                t.setString("YOUR TURN!\nPress Enter to attack\nEsc to run");
+
+                auto b = t.getGlobalBounds();
+                t.setPosition({ W / 2.f - b.size.x / 2.f, H / 2.f - 70.f });
+                draw(t);
+
+                sf::Text hpText(font);
+                setTextSize(hpText, 9);
+                hpText.setFillColor(sf::Color(200, 200, 200));
+                hpText.setString("Enemy HP: " + std::to_string(enemyHp) + "/" + std::to_string(enemyMaxHp));
+                auto hb = hpText.getGlobalBounds();
+                hpText.setPosition({ W / 2.f - hb.size.x / 2.f, H / 2.f + 40.f });
+                draw(hpText);
+            }
+        }
+        else if (mode == GameMode::DamageMsg) {
+            sf::RectangleShape overlay(sf::Vector2f((float)W, (float)H));
+            overlay.setFillColor(sf::Color(0, 0, 0, 200));
+            draw(overlay);
+
+            float eratio = (float)std::max(0.f, enemyHpShown) / (float)enemyMaxHp;
+
+            enemyHpBack.setPosition({ W / 2.f - 130.f, H / 2.f - 10.f });
+            enemyHpFill.setPosition(enemyHpBack.getPosition());
+            enemyHpFill.setSize({ 260.f * eratio, 12.f });
+
+            draw(enemyHpBack);
+            draw(enemyHpFill);
+
+            if (hasFont) {
+                sf::Text t(font);
+                setTextSize(t, 14);
+                t.setFillColor(sf::Color::White);
+                t.setString("YOU DID " + std::to_string(lastDamage) + " DAMAGE!\nHE IS ANGRY NOW");
+
+                auto b = t.getGlobalBounds();
+                t.setPosition({ W / 2.f - b.size.x / 2.f, H / 2.f - 80.f });
+                draw(t);
+
+                sf::Text hint(font);
+                setTextSize(hint, 8);
+                hint.setFillColor(sf::Color(200, 200, 200));
+                hint.setString("Press Enter to continue");
+
+                auto hb = hint.getGlobalBounds();
+                hint.setPosition({ W / 2.f - hb.size.x / 2.f, H / 2.f + 40.f });
+                draw(hint);
+            }
+        }
+        else if (mode == GameMode::EnemyDefeated) {
+            sf::RectangleShape overlay(sf::Vector2f((float)W, (float)H));
+            overlay.setFillColor(sf::Color(0, 0, 0, 210));
+            draw(overlay);
+
+            if (hasFont) {
+                sf::Text t(font);
+                setTextSize(t, 21);
+                t.setFillColor(sf::Color::White);
+                t.setStyle(sf::Text::Bold);
+                t.setString("ENEMY DEFEATED!");
+
+                auto b = t.getGlobalBounds();
+                t.setPosition({ W / 2.f - b.size.x / 2.f, H / 2.f - 40.f });
+                draw(t);
+
+                sf::Text h(font);
+                setTextSize(h, 9);
+                h.setFillColor(sf::Color(200, 200, 200));
+                h.setString("Press Enter to continue");
+                auto hb = h.getGlobalBounds();
+                h.setPosition({ W / 2.f - hb.size.x / 2.f, H / 2.f + 30.f });
+                draw(h);
+            }
+        }
+        else if (mode == GameMode::Victory) {
+            sf::RectangleShape overlay(sf::Vector2f((float)W, (float)H));
+            overlay.setFillColor(sf::Color(0, 0, 0, 200));
+            draw(overlay);
+
+            if (hasFont) {
+                auto b1 = victoryTitle.getGlobalBounds();
+                auto b2 = victoryHint.getGlobalBounds();
+
+                victoryTitle.setPosition({ W / 2.f - b1.size.x / 2.f, H / 2.f - 70.f });
+                victoryHint.setPosition({ W / 2.f - b2.size.x / 2.f, H / 2.f + 10.f });
+
+                draw(victoryTitle);
+                draw(victoryHint);
+            }
+        }
+        else { // GameOver
+            sf::RectangleShape overlay(sf::Vector2f((float)W, (float)H));
+            overlay.setFillColor(sf::Color(0, 0, 0, 180));
+            draw(overlay);
+
+            if (hasFont) {
+                sf::Text t(font);
+                setTextSize(t, 16);
+                t.setFillColor(sf::Color::Red);
+                t.setString("GAME OVER\nPress R to restart");
+                auto b = t.getGlobalBounds();
+                t.setPosition({ W / 2.f - b.size.x / 2.f, H / 2.f - 60.f });
+                draw(t);
+            }
+        }
+
+        // particles go on top of every screen, in one draw call
+        drawCalls += particles.draw(canvas);
+        };
+
+    // -----------------------------
+    // RENDER BENCHMARK: every draw path into the offscreen canvas, no window shown
+    // -----------------------------
+    if (benchRender) {
+        // kinds: 1 = straight drops only (stage 1), more = also the stage-2 kinds, round robin
+        struct BenchCase { const char* name; GameMode mode; int bullets; int kinds; };
+        const BenchCase cases[] = {
+            { "Overworld",     GameMode::Overworld,     0,     1 },
+            { "EncounterMenu", GameMode::EncounterMenu, 0,     1 },
+            { "SoulFlyIn",     GameMode::SoulFlyIn,     0,     1 },
+            { "Battle-0",      GameMode::Battle,        0,     1 },
+            { "Battle-200",    GameMode::Battle,        200,   1 },
+            { "Battle-2000",   GameMode::Battle,        2000,  1 },
+            { "Battle-10000",  GameMode::Battle,        10000, 1 },
+            { "Battle-mixed",  GameMode::Battle,        2000,  (int)BulletKind::Count },
+            { "AttackTurn",    GameMode::AttackTurn,    0,     1 },
+            { "DamageMsg",     GameMode::DamageMsg,     0,     1 },
+            { "EnemyDefeated", GameMode::EnemyDefeated, 0,     1 },
+            { "Victory",       GameMode::Victory,       0,     1 },
+            { "GameOver",      GameMode::GameOver,      0,     1 },
+        };
+
+        srand(1234); // same bullets / particles every run, so golden frames are comparable
+        if (!goldenDir.empty()) std::filesystem::create_directories(goldenDir);
+
+        std::cout << "render bench: " << benchFrames << " frames per mode, canvas "
+                  << canvas.getSize().x << "x" << canvas.getSize().y << "\n";
+        std::cout << std::left << std::setw(16) << "mode" << std::right
+                  << std::setw(14) << "submit ms" << std::setw(14) << "frame ms" << std::setw(12) << "draws" << "\n";
+
+        const sf::Vector2f boxCenterTL = {
+            leftOf(battleBox) + battleBox.size.x / 2.f - soul.size.x / 2.f,
+            topOf(battleBox) + battleBox.size.y / 2.f - soul.size.y / 2.f
         };
 
+        for (const BenchCase& c : cases) {
+            mode = c.mode;
+            encounter.active = true;
+            menuIndex = 1;
+            soul.hp = soul.maxHp;
+            soul.invuln = false;
+            enemyHp = enemyMaxHp - 70;
+            enemyHpShown = (float)enemyHp;
+            lastDamage = 70;
+            battleTime = 0.f;
+
+            soul.pos = boxCenterTL;
+            if (c.mode == GameMode::SoulFlyIn) {
+                sf::Vector2f from = worldToScreen(p.pos + p.size / 2.f) - soul.size / 2.f;
+                soul.pos = from + (boxCenterTL - from) * 0.5f;
+            }
+
+            bullets.clear();
+            for (int i = 0; i < c.bullets; ++i) {
+                sf::Vector2f at = { leftOf(battleBox) + (float)(rand() % (int)battleBox.size.x),
+                                    topOf(battleBox) + (float)(rand() % (int)battleBox.size.y) };
+                switch ((BulletKind)(i % c.kinds)) {
+                case BulletKind::Straight: bullets.straight.spawn(at, 6.f, Straight::attrs({ 0.f, 300.f })); break;
+                case BulletKind::Sine: bullets.sine.spawn(at, 6.f, SineWave::attrs(at.x, 260.f, 24.f, 6.f, 0.f)); break;
+                case BulletKind::Homing: bullets.homing.spawn(at, 6.f, Homing::attrs({ 0.f, 150.f }, 180.f, 2.5f, 0.9f)); break;
+                case BulletKind::Accel: bullets.accel.spawn(at, 6.f, Accel::attrs({ 0.f, 80.f }, { 0.f, 700.f })); break;
+                default: bullets.split.spawn(at, 6.f, Split::attrs({ 0.f, 200.f }, 0.6f, 6, 150.f)); break;
+                }
+            }
+
+            particles.clear();
+            if (c.mode == GameMode::EnemyDefeated)
+                particles.emitDissolve(enemyImg, enemyBattlePos, (float)pixelSize, 1, 0.6f, 1.2f);
+
+            // warm-up frame: first-use costs (glyphs, texture uploads) are not what we measure
+            drawFrame();
+            canvas.display();
+
+            drawCalls = 0;
+            sf::Time submit = sf::Time::Zero;
+            sf::Clock total;
+            for (int f = 0; f < benchFrames; ++f) {
+                sf::Clock sc;
+                drawFrame();
+                submit += sc.getElapsedTime();
+                canvas.display();
+            }
+            sf::Time frameTime = total.getElapsedTime();
+
+            std::cout << std::left << std::setw(16) << c.name << std::right << std::fixed << std::setprecision(3)
+                      << std::setw(14) << submit.asMicroseconds() / 1000.0 / benchFrames
+                      << std::setw(14) << frameTime.asMicroseconds() / 1000.0 / benchFrames
+                      << std::setw(12) << drawCalls / (unsigned)benchFrames << "\n";
+
+            if (!goldenDir.empty()) {
+                std::filesystem::path out = std::filesystem::path(goldenDir) / (string(c.name) + ".png");
+                if (!canvas.getTexture().copyToImage().saveToFile(out))
+                    std::cerr << "ERROR: couldn't write golden frame " << out.string() << "\n";
+            }
+        }
+        return 0;
+    }
+    telemetry.start("telemetry");
+    sessionClock.restart();
 
+    // -----------------------------
+    // IDLE SCREENS
+    // -----------------------------
+    // AttackTurn / Victory / GameOver (and EnemyDefeated once the dissolve is gone) show nothing
+    // that moves: redraw them only on input or a mode change and sleep in waitEvent in between
+    auto staticScreen = [&]() {
+        if (!particles.empty()) return false;
+        return mode == GameMode::AttackTurn || mode == GameMode::Victory ||
+            mode == GameMode::GameOver || mode == GameMode::EnemyDefeated;
+        };
+    bool dirty = true;            // input arrived since the last drawn frame
+    bool drawnStatic = false;     // the last drawn frame was a settled static screen
+    GameMode drawnMode = mode;
+
+    auto handleEvent = [&](const sf::Event& ev) {
+        if (ev.is<sf::Event::Closed>()) window.close();
+        if (auto* r = ev.getIf<sf::Event::Resized>()) {
+            window.setView(sf::View(sf::FloatRect({ 0.f, 0.f }, sf::Vector2f(r->size))));
+        }
+        // key releases count too, so justPressed() sees the key go up before the next press
+        if (ev.is<sf::Event::KeyPressed>() || ev.is<sf::Event::KeyReleased>() ||
+            ev.is<sf::Event::Resized>() || ev.is<sf::Event::FocusGained>())
+            dirty = true;
+        };
+
+    float frameWorkSec = 0.f; // time since the last presented frame, minus time spent asleep
     while (window.isOpen()) {
-        while (auto ev = window.pollEvent()) {
-            if (ev->is<sf::Event::Closed>()) window.close();
+        bool waited = false;
+        float sleptSec = 0.f;
+        if (drawnStatic && staticScreen() && !dirty) {
+            // EnemyDefeated still has to wake up for its auto-advance
+            float wait = (mode == GameMode::EnemyDefeated) ? max(0.001f, 1.5f - defeatTimer) : 0.25f;
+            sf::Clock sleepClock;
+            if (auto ev = window.waitEvent(sf::seconds(wait))) handleEvent(*ev);
+            sleptSec = sleepClock.getElapsedTime().asSeconds();
+            waited = true;
         }
+        while (auto ev = window.pollEvent()) handleEvent(*ev);
 
         float dt = clock.restart().asSeconds();
-        dt = min(dt, 0.05f);
+
+        telemetry.setTime((std::uint32_t)sessionClock.getElapsedTime().asMilliseconds(), (std::uint8_t)mode);
+        frameWorkSec += max(0.f, dt - sleptSec);
+
+        // a static screen has no physics to protect, so time spent asleep counts in full
+        if (!waited) dt = min(dt, 0.05f);
+
+        // -----------------------------
+        // WORLD STREAMING (requests + adopting finished chunks; never waits for the loader)
+        // -----------------------------
+        // (a new focus area may already be fully cached, so the field can need moving without a poll change)
+        world.setFocus(p.pos + p.size / 2.f);
+        if (world.poll() || world.focusBounds() != chaseArea) refreshWorld();
 
         // -----------------------------
         // MUSIC SWITCH ON MODE CHANGE
         // -----------------------------
         if (firstMusic || mode != lastMode) {
+            telemetry.record(TelemetryType::ModeChange, (std::uint16_t)mode, battleTime);
+
             switch (mode) {
             case GameMode::Overworld:
-                playMusic("assets/music/menu.mp3", true, 55.f);
+                playMusic("music/menu.mp3", true, 55.f);
                 break;
             case GameMode::EncounterMenu:
-                playMusic("assets/music/interaction.mp3", true, 55.f);
+                playMusic("music/interaction.mp3", true, 55.f);
                 break;
             case GameMode::SoulFlyIn:
             case GameMode::Battle:
             case GameMode::AttackTurn:
             case GameMode::DamageMsg:
             case GameMode::EnemyDefeated:
-                playMusic("assets/music/battle.mp3", true, 60.f);
+                playMusic("music/battle.mp3", true, 60.f);
                 break;
             case GameMode::Victory:
-                playMusic("assets/music/victory.mp3", false, 70.f);
+                playMusic("music/victory.mp3", false, 70.f);
                 break;
             case GameMode::GameOver:
-                playMusic("assets/music/gameover.mp3", true, 55.f);
+                playMusic("music/gameover.mp3", true, 55.f);
                 break;
             default:
                 break;
@@ -486,41 +1193,90 @@ int main() {
             }
 
             // direction for animation
-            walk.moving = (move.x != 0.f || move.y != 0.f);
-            if (walk.moving) {
-                if (fabs(move.x) > fabs(move.y)) {
-                    walk.dir = (move.x > 0) ? Dir::Right : Dir::Left;
-                }
-                else {
-                    walk.dir = (move.y > 0) ? Dir::Down : Dir::Up;
-                }
-            }
+            bool moving = (move.x != 0.f || move.y != 0.f);
+            actors.moving[playerActor] = moving;
+            if (moving) actors.dir[playerActor] = (std::uint8_t)dirFromMove(move);
 
             // movement + collision
             sf::Vector2f next = p.pos + move * p.speed * dt;
             sf::FloatRect pRect({ next.x, next.y }, { p.size.x, p.size.y });
 
-            bool blocked = false;
-            for (auto& w : walls) {
-                if (intersects(pRect, w)) { blocked = true; break; }
-            }
-            if (!blocked) p.pos = next;
+            if (!hitsWorld(pRect)) p.pos = next;
+
+            // villagers: pick a new heading now and then, stop when they bump into a wall
+            for (size_t k = 0; k < villagerVel.size(); ++k) {
+                size_t a = firstVillager + k;
+
+                villagerTurn[k] -= dt;
+                if (villagerTurn[k] <= 0.f) {
+                    villagerTurn[k] = 1.f + (float)(rand() % 200) / 100.f;
+                    switch (rand() % 5) {
+                    case 0: villagerVel[k] = { 0.f, -villagerSpeed }; break;
+                    case 1: villagerVel[k] = { 0.f, villagerSpeed }; break;
+                    case 2: villagerVel[k] = { -villagerSpeed, 0.f }; break;
+                    case 3: villagerVel[k] = { villagerSpeed, 0.f }; break;
+                    default: villagerVel[k] = { 0.f, 0.f }; break; // stand still
+                    }
+                }
+
+                sf::Vector2f vNext = actors.pos[a] + villagerVel[k] * dt;
+                sf::FloatRect vRect(vNext - p.size / 2.f, p.size);
+                bool vBlocked = (encounterResident && intersects(vRect, encounter.trigger)) || hitsWorld(vRect);
 
-            // animate frames
-            if (walk.moving) {
-                walk.timer += dt;
-                if (walk.timer >= walk.frameTime) {
-                    walk.timer = 0.f;
-                    walk.frame = (walk.frame + 1) % 4;
+                if (vBlocked) {
+                    villagerVel[k] = { 0.f, 0.f };
+                    villagerTurn[k] = 0.f;
                 }
+                else {
+                    actors.pos[a] = vNext;
+                }
+
+                actors.moving[a] = (villagerVel[k].x != 0.f || villagerVel[k].y != 0.f);
+                if (actors.moving[a]) actors.dir[a] = (std::uint8_t)dirFromMove(villagerVel[k]);
             }
-            else {
-                walk.frame = 0;
-                walk.timer = 0.f;
+
+            // chasers: follow the shared field, slide along walls, head straight for the
+            // player once in the same cell (or wherever the field has no answer yet)
+            const sf::Vector2f playerCenter = p.pos + p.size / 2.f;
+            chaseField.setGoal(playerCenter);
+            chaseField.update(chaseBudget);
+
+            const sf::FloatRect playerRect(p.pos, p.size);
+            for (size_t k = 0; k < chaserSpawn.size(); ++k) {
+                size_t a = firstChaser + k;
+
+                sf::Vector2f dir = (chaseField.ready() ? chaseField : chasePrevField).steer(actors.pos[a]);
+                if (dir.x == 0.f && dir.y == 0.f) {
+                    sf::Vector2f to = playerCenter - actors.pos[a];
+                    float len = sqrt(to.x * to.x + to.y * to.y);
+                    if (len > 1.f) dir = to / len;
+                }
+
+                sf::Vector2f step = dir * chaserSpeed * dt;
+                for (int axis = 0; axis < 2; ++axis) {
+                    sf::Vector2f cNext = actors.pos[a];
+                    if (axis == 0) cNext.x += step.x; else cNext.y += step.y;
+                    if (!hitsWorld(sf::FloatRect(cNext - p.size / 2.f, p.size))) actors.pos[a] = cNext;
+                }
+
+                actors.moving[a] = (dir.x != 0.f || dir.y != 0.f);
+                if (actors.moving[a]) actors.dir[a] = (std::uint8_t)dirFromMove(dir);
+
+                // caught: open the encounter and send this chaser back to its spawn
+                // (only while there is an enemy left to fight, same as the E trigger)
+                if (encounter.active && encounterResident &&
+                    intersects(sf::FloatRect(actors.pos[a] - p.size / 2.f, p.size), playerRect)) {
+                    actors.pos[a] = chaserSpawn[k];
+                    actors.moving[a] = false;
+                    mode = GameMode::EncounterMenu;
+                    menuIndex = 0;
+                }
             }
-            setPlayerFrame();
 
-            if (encounter.active) {
+            // animate frames (all actors, one pass)
+            actors.advance(anims, dt);
+
+            if (encounter.active && encounterResident) {
                 sf::FloatRect current({ p.pos.x, p.pos.y }, { p.size.x, p.size.y });
                 if (intersects(current, encounter.trigger) && justPressed(sf::Keyboard::Key::E, prevE)) {
                     mode = GameMode::EncounterMenu;
@@ -594,46 +1350,73 @@ int main() {
 
             spawnTimer += dt;
 
+            // telemetry Spawn: i0 = stage | kind << 8
+            auto recordSpawn = [&](BulletKind kind, float x, float vy) {
+                telemetry.record(TelemetryType::Spawn, (std::uint16_t)(battleStage | ((int)kind << 8)), x, vy);
+                };
+
             if (battleStage == 1) {
                 if (spawnTimer >= 0.25f) {
                     spawnTimer = 0.f;
 
-                    Bullet b;
                     float minX = leftOf(battleBox) + 12.f;
                     float maxX = rightOf(battleBox) - 12.f;
                     float x = minX + rand() % (int)(maxX - minX + 1.f);
+                    float vy = 260.f + (float)(rand() % 140);
 
-                    b.pos = { x, topOf(battleBox) - 10.f };
-                    b.vel = { 0.f, 260.f + (float)(rand() % 140) };
-                    b.r = 6.f;
-                    bullets.push_back(b);
+                    bullets.straight.spawn({ x, topOf(battleBox) - 10.f }, 6.f, Straight::attrs({ 0.f, vy }));
+                    recordSpawn(BulletKind::Straight, x, vy);
                 }
             }
             else {
+                // second defense: same rhythm, but only a third of the drops are straight
                 if (spawnTimer >= 0.18f) {
                     spawnTimer = 0.f;
 
                     for (int i = 0; i < 2; i++) {
-                        Bullet b;
-                        float minX = leftOf(battleBox) + 12.f;
-                        float maxX = rightOf(battleBox) - 12.f;
+                        float minX = leftOf(battleBox) + 24.f;
+                        float maxX = rightOf(battleBox) - 24.f;
                         float x = minX + rand() % (int)(maxX - minX + 1.f);
-
-                        b.pos = { x, topOf(battleBox) - 10.f };
-                        b.vel = { 0.f, 320.f + (float)(rand() % 180) };
-                        b.r = 6.f;
-                        bullets.push_back(b);
+                        float vy = 320.f + (float)(rand() % 180);
+                        sf::Vector2f at = { x, topOf(battleBox) - 10.f };
+
+                        int roll = rand() % 100;
+                        BulletKind kind;
+                        if (roll < 35) {
+                            kind = BulletKind::Straight;
+                            bullets.straight.spawn(at, 6.f, Straight::attrs({ 0.f, vy }));
+                        }
+                        else if (roll < 60) {
+                            kind = BulletKind::Sine;
+                            vy *= 0.7f;
+                            bullets.sine.spawn(at, 6.f, SineWave::attrs(x, vy, 24.f, 6.f, randRange(0.f, 6.28f)));
+                        }
+                        else if (roll < 78) {
+                            kind = BulletKind::Accel;
+                            vy = 80.f;
+                            bullets.accel.spawn(at, 6.f, Accel::attrs({ 0.f, vy }, { 0.f, 700.f }));
+                        }
+                        else if (roll < 90) {
+                            kind = BulletKind::Homing;
+                            vy = 150.f;
+                            bullets.homing.spawn(at, 6.f, Homing::attrs({ 0.f, vy }, 180.f, 2.5f, 0.9f));
+                        }
+                        else {
+                            kind = BulletKind::Split;
+                            vy = 200.f;
+                            bullets.split.spawn(at, 6.f, Split::attrs({ 0.f, vy }, randRange(0.45f, 0.7f), 6, 150.f));
+                        }
+                        recordSpawn(kind, x, vy);
                     }
                 }
             }
 
-            for (auto& b : bullets) {
-                b.update(dt);
-                if (b.pos.y > bottomOf(battleBox) + 40.f) b.alive = false;
-            }
-            bullets.erase(remove_if(bullets.begin(), bullets.end(),
-                [](const Bullet& b) { return !b.alive; }),
-                bullets.end());
+            // cull anything that leaves the box area (the old rule only culled below it)
+            BulletEnv bulletEnv;
+            bulletEnv.target = soul.pos + soul.size / 2.f;
+            bulletEnv.bounds = sf::FloatRect({ leftOf(battleBox) - 60.f, topOf(battleBox) - 60.f },
+                                             { battleBox.size.x + 120.f, battleBox.size.y + 100.f });
+            bullets.update(dt, bulletEnv);
 
             if (soul.invuln) {
                 soul.invulnTimer -= dt;
@@ -644,15 +1427,16 @@ int main() {
             }
 
             if (!soul.invuln) {
-                sf::FloatRect sr({ soul.pos.x, soul.pos.y }, soul.size);
-                for (auto& b : bullets) {
-                    sf::FloatRect br({ b.pos.x - b.r, b.pos.y - b.r }, { b.r * 2.f, b.r * 2.f });
-                    if (intersects(sr, br)) {
-                        soul.hp -= 5;
-                        soul.invuln = true;
-                        soul.invulnTimer = 0.6f;
-                        break;
-                    }
+                // exact circle-vs-heart test, SIMD straight over each kind's bucket
+                if (bullets.hitsHeart(heartHitbox, soul.pos)) {
+                    soul.hp -= 5;
+                    soul.invuln = true;
+                    soul.invulnTimer = 0.6f;
+                    telemetry.record(TelemetryType::SoulHit, (std::uint16_t)max(0, soul.hp), battleTime);
+
+                    sf::Vector2f sc = { soul.pos.x + soul.size.x / 2.f, soul.pos.y + soul.size.y / 2.f };
+                    particles.emitBurst(sc, 28, 80.f, 220.f, 0.2f, 0.5f, 3.f, sf::Color(255, 60, 60));
+                    particles.emitBurst(sc, 10, 40.f, 120.f, 0.1f, 0.3f, 2.f, sf::Color::White);
                 }
             }
 
@@ -679,6 +1463,9 @@ int main() {
                     mode = GameMode::EnemyDefeated;
                     defeatTimer = 0.f;
                     encounter.active = false;
+
+                    // crumble the enemy sprite where the battle last showed it
+                    particles.emitDissolve(enemyImg, enemyBattlePos, (float)pixelSize, 1, 0.6f, 1.2f);
                 }
                 else {
                     mode = GameMode::DamageMsg;
@@ -693,8 +1480,14 @@ int main() {
         }
         else if (mode == GameMode::DamageMsg) {
             if (!playedHpDownSfx) {
-                hpDownSfx.play();
+                mixer.playSfx(hpDownSfx, 0.7f);
+                mixer.setStemGain(0, 0.3f, 0.05f); // duck the battle track under the hit
                 playedHpDownSfx = true;
+
+                // burst where the HP bar will be cut (DamageMsg bar: 260px centered on screen)
+                float cutX = W / 2.f - 130.f + 260.f * (enemyHpTo / (float)enemyMaxHp);
+                particles.emitBurst({ cutX, H / 2.f - 4.f }, 60, 60.f, 260.f, 0.3f, 0.9f, 3.f, sf::Color(220, 80, 80), 300.f);
+                particles.emitBurst({ cutX, H / 2.f - 4.f }, 20, 30.f, 140.f, 0.2f, 0.5f, 2.f, sf::Color(255, 230, 120));
             }
 
             msgTimer += dt;
@@ -729,6 +1522,10 @@ int main() {
                 mode = GameMode::Overworld;
                 encounter.active = true;
                 p.pos = { 120.f, 260.f };
+                for (size_t k = 0; k < chaserSpawn.size(); ++k) {
+                    actors.pos[firstChaser + k] = chaserSpawn[k];
+                    actors.moving[firstChaser + k] = false;
+                }
             }
         }
         else if (mode == GameMode::Victory) {
@@ -737,262 +1534,21 @@ int main() {
             }
         }
 
-        // -----------------------------
-        // DRAW
-        // -----------------------------
-        window.clear(sf::Color(10, 10, 12));
-        window.draw(roomBg);
-
-        auto drawPlayerCenteredOnHitbox = [&]() {
-            playerSprite.setPosition({
-                p.pos.x + p.size.x / 2.f,
-                p.pos.y + p.size.y / 2.f
-                });
-            window.draw(playerSprite);
-            };
-
-        auto drawSoulCenteredOnHitbox = [&]() {
-            soulShape.setPosition({
-                soul.pos.x + soul.size.x / 2.f,
-                soul.pos.y + soul.size.y / 2.f
-                });
-            window.draw(soulShape);
-            };
-
-        if (mode == GameMode::Overworld) {
-            for (auto& w : walls) {
-                wallShape.setPosition(w.position);
-                wallShape.setSize(w.size);
-                window.draw(wallShape);
-            }
-
-            drawPlayerCenteredOnHitbox();
-
-            if (encounter.active) {
-                triggerOutline.setPosition(encounter.trigger.position);
-                triggerOutline.setSize(encounter.trigger.size);
-                window.draw(triggerOutline);
-                drawEnemyAtTrigger();
-            }
-        }
-        else if (mode == GameMode::EncounterMenu) {
-            for (auto& w : walls) {
-                wallShape.setPosition(w.position);
-                wallShape.setSize(w.size);
-                window.draw(wallShape);
-            }
-
-            drawPlayerCenteredOnHitbox();
-
-            if (encounter.active) {
-                triggerOutline.setPosition(encounter.trigger.position);
-                triggerOutline.setSize(encounter.trigger.size);
-                window.draw(triggerOutline);
-                drawEnemyAtTrigger();
-            }
-
-            window.draw(menuPanel);
-
-            sf::Vector2f base = menuPanel.getPosition();
-            sf::Vector2f opt1 = { base.x + 60.f, base.y + 90.f };
-            sf::Vector2f opt2 = { base.x + 60.f, base.y + 135.f };
-
-            sf::Vector2f selPos = (menuIndex == 0)
-                ? sf::Vector2f{ base.x + 35.f, base.y + 98.f }
-            : sf::Vector2f{ base.x + 35.f, base.y + 143.f };
-
-            selector.setPosition(selPos);
-            window.draw(selector);
-
-            if (hasFont) {
-                menuTitle.setPosition({ base.x + 40.f, base.y + 30.f });
-                optionWalk.setPosition(opt1);
-                optionAttack.setPosition(opt2);
-                hintText.setPosition({ base.x + 40.f, base.y + 175.f });
-
-                optionWalk.setFillColor(menuIndex == 0 ? sf::Color::Yellow : sf::Color::White);
-                optionAttack.setFillColor(menuIndex == 1 ? sf::Color::Yellow : sf::Color::White);
-
-                window.draw(menuTitle);
-                window.draw(optionWalk);
-                window.draw(optionAttack);
-                window.draw(hintText);
-            }
-        }
-        else if (mode == GameMode::SoulFlyIn) {
-            // show overworld while heart flies in (looks like Undertale transition)
-            for (auto& w : walls) {
-                wallShape.setPosition(w.position);
-                wallShape.setSize(w.size);
-                window.draw(wallShape);
-            }
-
-            if (encounter.active) {
-                triggerOutline.setPosition(encounter.trigger.position);
-                triggerOutline.setSize(encounter.trigger.size);
-                window.draw(triggerOutline);
-                drawEnemyAtTrigger();
-            }
-
-            // draw the battle box outline so you see the target
-            window.draw(boxShape);
-
-            // draw heart flying
-            drawSoulCenteredOnHitbox();
-        }
-        else if (mode == GameMode::Battle) {
-            window.draw(boxShape);
-
-            for (auto& b : bullets) {
-                sf::CircleShape c(b.r);
-                c.setFillColor(sf::Color::White);
-                c.setPosition(sf::Vector2f{ b.pos.x - b.r, b.pos.y - b.r });
-                window.draw(c);
-            }
-
-            // blink during invuln
-            if (!soul.invuln || fmod(battleTime * 10.f, 2.f) < 1.f) {
-                drawSoulCenteredOnHitbox();
-            }
-
-            float ratio = (float)max(0, soul.hp) / (float)soul.maxHp;
-            hpFill.setSize(sf::Vector2f{ 240.f * ratio, 16.f });
-            window.draw(hpBack);
-            window.draw(hpFill);
-
-            // enemy sprite above battle box
-            enemySprite.setPosition(sf::Vector2f{ leftOf(battleBox) + battleBox.size.x / 2.f, topOf(battleBox) - 90.f });
-            window.draw(enemySprite);
-
-            float eratio = (float)std::max(0, enemyHp) / (float)enemyMaxHp;
-
-            enemyHpBack.setPosition({
-                leftOf(battleBox) + battleBox.size.x / 2.f - 130.f,
-                topOf(battleBox) - 25.f
-                });
-
-            enemyHpFill.setPosition(enemyHpBack.getPosition());
-            enemyHpFill.setSize({ 260.f * eratio, 12.f });
-
-            window.draw(enemyHpBack);
-            window.draw(enemyHpFill);
-        }
-        else if (mode == GameMode::AttackTurn) {
-            sf::RectangleShape overlay(sf::Vector2f((float)W, (float)H));
-            overlay.setFillColor(sf::Color(0, 0, 0, 160));
-            window.draw(overlay);
-
-            if (hasFont) {
-                sf::Text t(font);
-                t.setCharacterSize(28);
-                t.setFillColor(sf::Color::White);
-                t.setString("YOUR TURN!\nPress Enter to attack\nEsc to run");
-
-                auto b = t.getLocalBounds();
-                t.setPosition({ W / 2.f - b.size.x / 2.f, H / 2.f - 70.f });
-                window.draw(t);
-
-                sf::Text hpText(font);
-                hpText.setCharacterSize(18);
-                hpText.setFillColor(sf::Color(200, 200, 200));
-                hpText.setString("Enemy HP: " + std::to_string(enemyHp) + "/" + std::to_string(enemyMaxHp));
-                auto hb = hpText.getLocalBounds();
-                hpText.setPosition({ W / 2.f - hb.size.x / 2.f, H / 2.f + 40.f });
-                window.draw(hpText);
-            }
-        }
-        else if (mode == GameMode::DamageMsg) {
-            sf::RectangleShape overlay(sf::Vector2f((float)W, (float)H));
-            overlay.setFillColor(sf::Color(0, 0, 0, 200));
-            window.draw(overlay);
-
-            float eratio = (float)std::max(0.f, enemyHpShown) / (float)enemyMaxHp;
-
-            enemyHpBack.setPosition({ W / 2.f - 130.f, H / 2.f - 10.f });
-            enemyHpFill.setPosition(enemyHpBack.getPosition());
-            enemyHpFill.setSize({ 260.f * eratio, 12.f });
-
-            window.draw(enemyHpBack);
-            window.draw(enemyHpFill);
-
-            if (hasFont) {
-                sf::Text t(font);
-                t.setCharacterSize(28);
-                t.setFillColor(sf::Color::White);
-                t.setString("YOU DID " + std::to_string(lastDamage) + " DAMAGE!\nHE IS ANGRY NOW");
+        particles.update(dt);
 
-                auto b = t.getLocalBounds();
-                t.setPosition({ W / 2.f - b.size.x / 2.f, H / 2.f - 80.f });
-                window.draw(t);
+        if (dirty || mode != drawnMode || !drawnStatic || !staticScreen()) {
+            drawFrame();
+            canvas.display();
+            presentCanvas(window, canvas);
 
-                sf::Text hint(font);
-                hint.setCharacterSize(16);
-                hint.setFillColor(sf::Color(200, 200, 200));
-                hint.setString("Press Enter to continue");
+            // one Frame sample per presented frame; sleeping on a static screen isn't frame time
+            telemetry.record(TelemetryType::Frame, 0, frameWorkSec * 1000.f);
+            frameWorkSec = 0.f;
 
-                auto hb = hint.getLocalBounds();
-                hint.setPosition({ W / 2.f - hb.size.x / 2.f, H / 2.f + 40.f });
-                window.draw(hint);
-            }
+            drawnMode = mode;
+            drawnStatic = staticScreen();
+            dirty = false;
         }
-        else if (mode == GameMode::EnemyDefeated) {
-            sf::RectangleShape overlay(sf::Vector2f((float)W, (float)H));
-            overlay.setFillColor(sf::Color(0, 0, 0, 210));
-            window.draw(overlay);
-
-            if (hasFont) {
-                sf::Text t(font);
-                t.setCharacterSize(42);
-                t.setFillColor(sf::Color::White);
-                t.setStyle(sf::Text::Bold);
-                t.setString("ENEMY DEFEATED!");
-
-                auto b = t.getLocalBounds();
-                t.setPosition({ W / 2.f - b.size.x / 2.f, H / 2.f - 40.f });
-                window.draw(t);
-
-                sf::Text h(font);
-                h.setCharacterSize(18);
-                h.setFillColor(sf::Color(200, 200, 200));
-                h.setString("Press Enter to continue");
-                auto hb = h.getLocalBounds();
-                h.setPosition({ W / 2.f - hb.size.x / 2.f, H / 2.f + 30.f });
-                window.draw(h);
-            }
-        }
-        else if (mode == GameMode::Victory) {
-            sf::RectangleShape overlay(sf::Vector2f((float)W, (float)H));
-            overlay.setFillColor(sf::Color(0, 0, 0, 200));
-            window.draw(overlay);
-
-            if (hasFont) {
-                auto b1 = victoryTitle.getLocalBounds();
-                auto b2 = victoryHint.getLocalBounds();
-
-                victoryTitle.setPosition({ W / 2.f - b1.size.x / 2.f, H / 2.f - 70.f });
-                victoryHint.setPosition({ W / 2.f - b2.size.x / 2.f, H / 2.f + 10.f });
-
-                window.draw(victoryTitle);
-                window.draw(victoryHint);
-            }
-        }
-        else { // GameOver
-            sf::RectangleShape overlay(sf::Vector2f((float)W, (float)H));
-            overlay.setFillColor(sf::Color(0, 0, 0, 180));
-            window.draw(overlay);
-
-            if (hasFont) {
-                sf::Text t(font);
-                t.setCharacterSize(32);
-                t.setFillColor(sf::Color::Red);
-                t.setString("GAME OVER\nPress R to restart");
-                auto b = t.getLocalBounds();
-                t.setPosition({ W / 2.f - b.size.x / 2.f, H / 2.f - 60.f });
-                window.draw(t);
-            }
-        }
-
-        window.display();
     }
 
     return 0;
@@ -0,0 +1,308 @@
+#pragma once
+// flowfield.h
+// - One shared flow field toward the player over a collision grid (instead of A* per enemy)
+// - Built breadth-first from the goal; every cell remembers the neighbor it was reached from,
+//   so steering is a single lookup: O(1) per chaser no matter how many there are
+// - Rebuilds are incremental: update(budget) expands at most `budget` cells per frame into a second
+//   buffer while chasers keep using the last finished field. A goal change never restarts a build
+//   in progress; it is queued and started when the current one publishes, so a fresh field comes
+//   out at least every cellCount() / budget frames however fast the player moves
+// - runFlowFieldBench(): `game --bench-flowfield`, field update time against map size
+
+#include <SFML/Graphics.hpp>
+
+#include <vector>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <algorithm>
+
+// cells the chasers' field may expand per frame (the game and the bench both use it)
+static constexpr size_t kFlowFieldFrameBudget = 2048;
+
+class FlowField {
+public:
+    static constexpr std::uint32_t kUnreached = 0xFFFFFFFFu;
+    static constexpr std::uint8_t kNoDir = 8;
+
+    void init(sf::Vector2f worldOrigin, sf::Vector2i gridSize, float cellSize) {
+        origin = worldOrigin;
+        cols = std::max(1, gridSize.x);
+        rows = std::max(1, gridSize.y);
+        cell = cellSize;
+
+        const size_t n = (size_t)cols * rows;
+        blocked.assign(n, 0);
+        dist.assign(n, kUnreached);
+        flow.assign(n, kNoDir);
+        workDist.assign(n, kUnreached);
+        workFlow.assign(n, kNoDir);
+        queue.assign(n, 0);
+
+        goal = -1;
+        pendingGoal = -1;
+        stale = false;
+        building = false;
+        published = false;
+    }
+
+    // a cell is blocked if an agent of `agentSize` centered on it would overlap a wall
+    void setBlockedFromWalls(const std::vector<sf::FloatRect>& walls, sf::Vector2f agentSize) {
+        refreshBlocked(sf::FloatRect(origin, { cols * cell, rows * cell }), walls, agentSize,
+                       [](sf::Vector2f) { return true; });
+    }
+
+    // recomputes only the cells whose centers lie in `area` (e.g. a chunk that just loaded):
+    // blocked when isOpen(center) is false or an agent there would overlap one of `walls`
+    template <class OpenFn>
+    void refreshBlocked(sf::FloatRect area, const std::vector<sf::FloatRect>& walls, sf::Vector2f agentSize, OpenFn isOpen) {
+        const int ax0 = std::max(0, (int)std::ceil((area.position.x - origin.x) / cell - 0.5f));
+        const int ay0 = std::max(0, (int)std::ceil((area.position.y - origin.y) / cell - 0.5f));
+        const int ax1 = std::min(cols - 1, (int)std::ceil((area.position.x + area.size.x - origin.x) / cell - 0.5f) - 1);
+        const int ay1 = std::min(rows - 1, (int)std::ceil((area.position.y + area.size.y - origin.y) / cell - 0.5f) - 1);
+        if (ax0 > ax1 || ay0 > ay1) return;
+
+        for (int y = ay0; y <= ay1; ++y)
+            for (int x = ax0; x <= ax1; ++x)
+                blocked[(size_t)y * cols + x] = isOpen(cellCenter(y * cols + x)) ? 0 : 1;
+
+        const sf::Vector2f h = { agentSize.x / 2.f, agentSize.y / 2.f };
+        for (const sf::FloatRect& w : walls) {
+            int x0 = std::max(ax0, (int)std::floor((w.position.x - h.x - origin.x) / cell));
+            int y0 = std::max(ay0, (int)std::floor((w.position.y - h.y - origin.y) / cell));
+            int x1 = std::min(ax1, (int)std::floor((w.position.x + w.size.x + h.x - origin.x) / cell));
+            int y1 = std::min(ay1, (int)std::floor((w.position.y + w.size.y + h.y - origin.y) / cell));
+            for (int y = y0; y <= y1; ++y) {
+                for (int x = x0; x <= x1; ++x) {
+                    sf::Vector2f c = cellCenter(y * cols + x);
+                    if (c.x + h.x > w.position.x && c.x - h.x < w.position.x + w.size.x &&
+                        c.y + h.y > w.position.y && c.y - h.y < w.position.y + w.size.y)
+                        blocked[(size_t)y * cols + x] = 1;
+                }
+            }
+        }
+        // the published field may route through new walls: rebuild toward the same goal next
+        if (goal >= 0) stale = true;
+    }
+
+    void setBlocked(int x, int y, bool b) { blocked[(size_t)y * cols + x] = b ? 1 : 0; }
+
+    // asks for a field toward worldPos. Starts a build right away only when none is running;
+    // otherwise the newest goal waits for the current build to publish. True if a build started
+    bool setGoal(sf::Vector2f worldPos) {
+        int c = cellOf(worldPos);
+        if (c < 0) return false;
+        if (building) {
+            pendingGoal = (c == goal) ? -1 : c;
+            return false;
+        }
+        if (c == goal && !stale) return false;
+        pendingGoal = -1;
+        beginBuild(c);
+        return true;
+    }
+
+    // expands up to `budget` cells, starting the queued goal once the current build is done;
+    // true when a new field was published
+    bool update(size_t budget) {
+        bool publishedNow = false;
+        while (budget > 0) {
+            if (!building) {
+                const int next = pendingGoal >= 0 ? pendingGoal : (stale ? goal : -1);
+                if (next < 0) break;
+                pendingGoal = -1;
+                beginBuild(next);
+            }
+            budget = expand(budget);
+            if (qHead < qTail) break;
+
+            dist.swap(workDist);
+            flow.swap(workFlow);
+            building = false;
+            published = true;
+            publishedNow = true;
+        }
+        return publishedNow;
+    }
+
+    void rebuildNow() { while (busy()) update((size_t)-1); }
+
+    bool ready() const { return published; }
+    bool busy() const { return building || pendingGoal >= 0 || (stale && goal >= 0); }
+
+    // unit direction to follow from worldPos, or {0,0} when the field has no answer there
+    // (outside the grid, nothing reached around it, or already in the goal cell: steer straight at
+    // the target then). An agent touching a wall can stand in a blocked cell, because cells are
+    // blocked by their center plus half the agent size; it heads for the nearest reached neighbor
+    sf::Vector2f steer(sf::Vector2f worldPos) const {
+        if (!published) return { 0.f, 0.f };
+        const int c = cellOf(worldPos);
+        if (c < 0) return { 0.f, 0.f };
+
+        const int cx = c % cols, cy = c / cols;
+        int next = -1;
+        if (dist[c] != kUnreached) {
+            if (flow[c] == kNoDir) return { 0.f, 0.f };
+            next = (cy + kDy[flow[c]]) * cols + cx + kDx[flow[c]];
+        }
+        else {
+            float best = 0.f;
+            for (int k = 0; k < 8; ++k) {
+                const int nx = cx + kDx[k], ny = cy + kDy[k];
+                if (nx < 0 || ny < 0 || nx >= cols || ny >= rows) continue;
+                const int n = ny * cols + nx;
+                if (dist[n] == kUnreached) continue;
+                sf::Vector2f d = cellCenter(n) - worldPos;
+                float d2 = d.x * d.x + d.y * d.y;
+                if (next < 0 || d2 < best) { next = n; best = d2; }
+            }
+            if (next < 0) return { 0.f, 0.f };
+        }
+
+        sf::Vector2f to = cellCenter(next) - worldPos;
+        float len = std::sqrt(to.x * to.x + to.y * to.y);
+        if (len < 0.001f) return { 0.f, 0.f };
+        return to / len;
+    }
+
+    int cellOf(sf::Vector2f worldPos) const {
+        int x = (int)std::floor((worldPos.x - origin.x) / cell);
+        int y = (int)std::floor((worldPos.y - origin.y) / cell);
+        if (x < 0 || y < 0 || x >= cols || y >= rows) return -1;
+        return y * cols + x;
+    }
+
+    sf::Vector2f cellCenter(int c) const {
+        return { origin.x + ((c % cols) + 0.5f) * cell, origin.y + ((c / cols) + 0.5f) * cell };
+    }
+
+    size_t cellCount() const { return (size_t)cols * rows; }
+
+private:
+    // neighbor order is symmetric, so 7 - k is the opposite of k
+    static constexpr int kDx[8] = { -1, 0, 1, -1, 1, -1, 0, 1 };
+    static constexpr int kDy[8] = { -1, -1, -1, 0, 0, 1, 1, 1 };
+
+    // pops up to `budget` cells off the wavefront; returns the budget left over
+    size_t expand(size_t budget) {
+        while (qHead < qTail && budget > 0) {
+            const int c = queue[qHead++];
+            --budget;
+
+            const int cx = c % cols, cy = c / cols;
+            const std::uint32_t d = workDist[c] + 1;
+            for (std::uint8_t k = 0; k < 8; ++k) {
+                const int nx = cx + kDx[k], ny = cy + kDy[k];
+                if (nx < 0 || ny < 0 || nx >= cols || ny >= rows) continue;
+                const int n = ny * cols + nx;
+                if (blocked[n] || workDist[n] != kUnreached) continue;
+                // no cutting corners: a diagonal step needs both orthogonal cells open
+                if (kDx[k] != 0 && kDy[k] != 0 &&
+                    (blocked[cy * cols + nx] || blocked[ny * cols + cx])) continue;
+
+                workDist[n] = d;
+                workFlow[n] = (std::uint8_t)(7 - k); // opposite direction: back toward c
+                queue[qTail++] = n;
+            }
+        }
+        return budget;
+    }
+
+    void beginBuild(int goalCell) {
+        goal = goalCell;
+        stale = false;
+        std::fill(workDist.begin(), workDist.end(), kUnreached);
+        std::fill(workFlow.begin(), workFlow.end(), kNoDir);
+
+        // the goal is seeded even if its cell counts as blocked (the player can stand closer
+        // to a wall than a cell center can)
+        workDist[goal] = 0;
+        queue[0] = goal;
+        qHead = 0;
+        qTail = 1;
+        building = true;
+    }
+
+    sf::Vector2f origin{ 0.f, 0.f };
+    int cols = 0, rows = 0;
+    float cell = 1.f;
+
+    std::vector<std::uint8_t> blocked;
+    std::vector<std::uint32_t> dist;     // published field (steps to goal)
+    std::vector<std::uint8_t> flow;      // published: neighbor index to move to
+    std::vector<std::uint32_t> workDist; // field being built
+    std::vector<std::uint8_t> workFlow;
+    std::vector<int> queue;
+    size_t qHead = 0, qTail = 0;
+
+    int goal = -1;        // goal of the build in progress (or of the published field)
+    int pendingGoal = -1; // newest goal requested while a build was running
+    bool stale = false;   // blocked cells changed since the current build started
+    bool building = false;
+    bool published = false;
+};
+
+// -----------------------------
+// Benchmark: field update time vs map size
+// -----------------------------
+static void runFlowFieldBench() {
+    using Clock = std::chrono::steady_clock;
+
+    std::cout << "flow field: full rebuild, budgeted update and steering cost vs map size (10% walls)\n";
+    std::cout << std::setw(10) << "grid" << std::setw(10) << "cells"
+              << std::setw(14) << "rebuild ms" << std::setw(16) << ("frames@" + std::to_string(kFlowFieldFrameBudget))
+              << std::setw(16) << "moving: fr/pub"
+              << std::setw(18) << "steer ns/agent" << "\n";
+
+    for (int side : { 64, 128, 256, 512, 1024 }) {
+        FlowField f;
+        f.init({ 0.f, 0.f }, { side, side }, 1.f);
+        for (int y = 0; y < side; ++y)
+            for (int x = 0; x < side; ++x)
+                if (rand() % 10 == 0) f.setBlocked(x, y, true);
+
+        // full rebuilds as the goal wanders
+        const int rebuilds = std::max(3, 4096 / side);
+        auto t0 = Clock::now();
+        for (int i = 0; i < rebuilds; ++i) {
+            f.setGoal({ (float)(rand() % side) + 0.5f, (float)(rand() % side) + 0.5f });
+            f.rebuildNow();
+        }
+        auto t1 = Clock::now();
+
+        // how many frames a rebuild takes with the in-game budget
+        f.setGoal({ side / 2.f + 0.5f, side / 2.f + 0.5f });
+        int frames = 0;
+        while (f.busy()) { f.update(kFlowFieldFrameBudget); ++frames; }
+
+        // goal changing cell every frame (a running player): frames between published fields
+        int movingFrames = 0, publishes = 0;
+        for (; movingFrames < 2000 && publishes < 20; ++movingFrames) {
+            f.setGoal({ (float)(movingFrames % side) + 0.5f, side / 2.f + 0.5f });
+            if (f.update(kFlowFieldFrameBudget)) ++publishes;
+        }
+
+        // O(1) steering for many agents
+        const int agents = 100000;
+        std::vector<sf::Vector2f> pos(agents);
+        for (auto& p : pos) p = { (float)(rand() % (side * 100)) / 100.f, (float)(rand() % (side * 100)) / 100.f };
+        volatile float sink = 0.f;
+        auto t2 = Clock::now();
+        for (auto& p : pos) { sf::Vector2f d = f.steer(p); sink = sink + d.x + d.y; }
+        auto t3 = Clock::now();
+
+        double rebuildMs = std::chrono::duration<double, std::milli>(t1 - t0).count() / rebuilds;
+        double steerNs = std::chrono::duration<double, std::nano>(t3 - t2).count() / agents;
+        std::cout << std::setw(6) << side << "x" << std::setw(3) << std::left << side << std::right
+                  << std::setw(10) << f.cellCount()
+                  << std::setw(14) << std::fixed << std::setprecision(3) << rebuildMs
+                  << std::setw(16) << frames
+                  << std::setw(16) << std::setprecision(1) << (publishes ? (double)movingFrames / publishes : 0.0)
+                  << std::setw(18) << std::setprecision(2) << steerNs << "\n";
+    }
+}
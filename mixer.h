@@ -0,0 +1,369 @@
+#pragma once
+// mixer.h
+// - One sf::SoundStream that mixes everything: music stems and a pool of SFX voices
+//   (one OpenAL source for the whole game instead of one per sf::Music / sf::Sound)
+// - Music is decoded on the audio thread straight from the asset pack, SFX are decoded once at load;
+//   both are converted to 44.1 kHz stereo float so the mix loop has a single format
+// - Every voice has a per-sample gain ramp: track changes are crossfades that start on the same
+//   sample, and the mix/convert loops run 4 samples per instruction with SSE (scalar fallback)
+// - The game thread never touches voices: it pushes commands that the audio thread applies at the
+//   start of its next block
+
+#include <SFML/Audio.hpp>
+
+#include "assetpack.h"
+
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MIXER_SSE 1
+#include <emmintrin.h>
+#endif
+
+static constexpr unsigned kMixRate = 44100;
+static constexpr size_t kMixBlockFrames = 1024; // ~23 ms per onGetData
+
+// fully decoded sound (SFX): interleaved stereo float at kMixRate
+struct MixClip {
+    std::vector<float> samples;
+    size_t frames() const { return samples.size() / 2; }
+};
+
+// Streaming decoder: any channel count / sample rate in, stereo float at kMixRate out
+// (mono is duplicated, extra channels are dropped, other rates are linearly resampled)
+class MixStream {
+public:
+    bool open(AssetView src, bool loopTrack) {
+        if (!src || !file.openFromMemory(src.data, src.size)) return false;
+        channels = file.getChannelCount();
+        if (channels == 0 || file.getSampleRate() == 0) return false;
+
+        loop = loopTrack;
+        step = (double)file.getSampleRate() / kMixRate;
+        raw.resize(4096 * channels);
+        rawFrames = rawPos = 0;
+        frac = 1.0;
+        ended = false;
+        return true;
+    }
+
+    // writes `frames` stereo frames and returns how many came from the track
+    // (fewer only when a non-looping track ends; the rest is silence)
+    size_t read(float* out, size_t frames) {
+        size_t i = 0;
+        if (step == 1.0) {
+            // same rate: no interpolation
+            for (; i < frames && nextFrame(cur); ++i) {
+                out[i * 2] = cur[0];
+                out[i * 2 + 1] = cur[1];
+            }
+        }
+        else {
+            for (; i < frames; ++i) {
+                while (frac >= 1.0) {
+                    prev[0] = cur[0];
+                    prev[1] = cur[1];
+                    if (!nextFrame(cur)) break;
+                    frac -= 1.0;
+                }
+                if (ended) break;
+                const float t = (float)frac;
+                out[i * 2] = prev[0] + (cur[0] - prev[0]) * t;
+                out[i * 2 + 1] = prev[1] + (cur[1] - prev[1]) * t;
+                frac += step;
+            }
+        }
+        if (i < frames) std::memset(out + i * 2, 0, (frames - i) * 2 * sizeof(float));
+        return i;
+    }
+
+private:
+    bool nextFrame(float* lr) {
+        if (ended) return false;
+        if (rawPos >= rawFrames) {
+            rawFrames = (size_t)(file.read(raw.data(), raw.size()) / channels);
+            if (rawFrames == 0 && loop) {
+                file.seek(0);
+                rawFrames = (size_t)(file.read(raw.data(), raw.size()) / channels);
+            }
+            rawPos = 0;
+            if (rawFrames == 0) {
+                ended = true;
+                return false;
+            }
+        }
+        const std::int16_t* s = &raw[rawPos * channels];
+        lr[0] = s[0] * (1.f / 32768.f);
+        lr[1] = (channels > 1 ? s[1] : s[0]) * (1.f / 32768.f);
+        ++rawPos;
+        return true;
+    }
+
+    sf::InputSoundFile file;
+    unsigned channels = 0;
+    bool loop = false;
+    bool ended = true;
+
+    std::vector<std::int16_t> raw;
+    size_t rawFrames = 0, rawPos = 0;
+
+    double step = 1.0, frac = 1.0;
+    float prev[2] = { 0.f, 0.f };
+    float cur[2] = { 0.f, 0.f };
+};
+
+// acc += src * gain, with gain ramping by `step` per frame and stopping at `target`;
+// returns the gain after `frames` frames
+static float mixRamp(float* acc, const float* src, size_t frames, float gain, float target, float step) {
+    size_t i = 0;
+#ifdef MIXER_SSE
+    // two stereo frames per vector: gains {g, g, g+s, g+s}
+    __m128 g = _mm_setr_ps(gain, gain, gain + step, gain + step);
+    const __m128 inc = _mm_set1_ps(step * 2.f);
+    const __m128 tgt = _mm_set1_ps(target);
+    const bool up = step >= 0.f;
+    for (; i + 2 <= frames; i += 2) {
+        __m128 gc = up ? _mm_min_ps(g, tgt) : _mm_max_ps(g, tgt);
+        __m128 a = _mm_loadu_ps(acc + i * 2);
+        __m128 s = _mm_loadu_ps(src + i * 2);
+        _mm_storeu_ps(acc + i * 2, _mm_add_ps(a, _mm_mul_ps(s, gc)));
+        g = _mm_add_ps(g, inc);
+    }
+#endif
+    for (; i < frames; ++i) {
+        float gi = gain + step * (float)i;
+        gi = step >= 0.f ? std::min(gi, target) : std::max(gi, target);
+        acc[i * 2] += src[i * 2] * gi;
+        acc[i * 2 + 1] += src[i * 2 + 1] * gi;
+    }
+    float end = gain + step * (float)frames;
+    return step >= 0.f ? std::min(end, target) : std::max(end, target);
+}
+
+// float mix -> int16 with saturation
+static void mixToPcm16(const float* in, std::int16_t* out, size_t samples, float master) {
+    const float k = master * 32767.f;
+    size_t i = 0;
+#ifdef MIXER_SSE
+    const __m128 kv = _mm_set1_ps(k);
+    for (; i + 8 <= samples; i += 8) {
+        __m128i a = _mm_cvtps_epi32(_mm_mul_ps(_mm_loadu_ps(in + i), kv));
+        __m128i b = _mm_cvtps_epi32(_mm_mul_ps(_mm_loadu_ps(in + i + 4), kv));
+        _mm_storeu_si128((__m128i*)(out + i), _mm_packs_epi32(a, b));
+    }
+#endif
+    for (; i < samples; ++i) {
+        float v = std::min(32767.f, std::max(-32768.f, in[i] * k));
+        out[i] = (std::int16_t)std::lround(v);
+    }
+}
+
+class AudioMixer : public sf::SoundStream {
+public:
+    static constexpr int kMusicVoices = 8; // incoming stems + the ones still fading out
+    static constexpr int kSfxVoices = 16;
+
+    AudioMixer() : musicVoices(kMusicVoices), sfxVoices(kSfxVoices) {
+        initialize(2, kMixRate, { sf::SoundChannel::FrontLeft, sf::SoundChannel::FrontRight });
+        mix.resize(kMixBlockFrames * 2);
+        scratch.resize(kMixBlockFrames * 2);
+        pcm.resize(kMixBlockFrames * 2);
+        pending.reserve(64);
+        applying.reserve(64);
+    }
+    ~AudioMixer() override { stop(); }
+
+    // game thread, load time: decode a whole sound; the mixer owns it for its lifetime
+    const MixClip* loadClip(AssetView src) {
+        MixStream s;
+        if (!s.open(src, false)) return nullptr;
+        auto clip = std::make_unique<MixClip>();
+        std::vector<float> block(kMixBlockFrames * 2);
+        size_t n = kMixBlockFrames;
+        while (n == kMixBlockFrames) {
+            n = s.read(block.data(), kMixBlockFrames);
+            clip->samples.insert(clip->samples.end(), block.begin(), block.begin() + n * 2);
+        }
+        clips.push_back(std::move(clip));
+        return clips.back().get();
+    }
+
+    // crossfade to a new track: every stem starts on the same sample and fades in over `fadeSec`
+    // while whatever was playing fades out over the same samples
+    bool playMusic(const std::vector<AssetView>& stems, const std::vector<float>& gains, bool loop, float fadeSec) {
+        Command c;
+        c.kind = Command::Music;
+        c.fade = fadeSec;
+        for (size_t i = 0; i < stems.size() && i < (size_t)kMusicVoices / 2; ++i) {
+            auto s = std::make_unique<MixStream>();
+            if (!s->open(stems[i], loop)) return false;
+            c.stems.push_back(std::move(s));
+            c.gains.push_back(i < gains.size() ? gains[i] : 1.f);
+        }
+        push(std::move(c));
+        return true;
+    }
+
+    // ramp one stem of the current track (ducking, layering)
+    void setStemGain(int stem, float gain, float rampSec) {
+        Command c;
+        c.kind = Command::StemGain;
+        c.stem = stem;
+        c.gain = gain;
+        c.fade = rampSec;
+        push(std::move(c));
+    }
+
+    void stopMusic(float fadeSec) {
+        Command c;
+        c.kind = Command::Music;
+        c.fade = fadeSec;
+        push(std::move(c));
+    }
+
+    // fire-and-forget; when all voices are busy the one closest to finishing is replaced
+    void playSfx(const MixClip* clip, float gain) {
+        if (!clip || clip->frames() == 0) return;
+        Command c;
+        c.kind = Command::Sfx;
+        c.clip = clip;
+        c.gain = gain;
+        push(std::move(c));
+    }
+
+    void setMasterGain(float g) { master.store(g, std::memory_order_relaxed); }
+
+private:
+    struct Command {
+        enum Kind { Music, StemGain, Sfx } kind = Sfx;
+        std::vector<std::unique_ptr<MixStream>> stems;
+        std::vector<float> gains;
+        const MixClip* clip = nullptr;
+        int stem = -1;
+        float gain = 1.f;
+        float fade = 0.f;
+    };
+
+    struct Voice {
+        bool active = false;
+        int stem = -1;                     // stem index in the current track, -1 once it is fading out
+        std::unique_ptr<MixStream> stream; // music
+        const MixClip* clip = nullptr;     // sfx
+        size_t pos = 0;
+        float gain = 0.f, target = 0.f, step = 0.f;
+        bool stopAtTarget = false;         // fade-outs free the voice when the ramp ends
+    };
+
+    static void rampTo(Voice& v, float target, float seconds) {
+        v.target = target;
+        const float frames = seconds * (float)kMixRate;
+        if (frames < 1.f) { v.gain = target; v.step = 0.f; }
+        else v.step = (target - v.gain) / frames;
+    }
+
+    void push(Command&& c) {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        pending.push_back(std::move(c));
+    }
+
+    // audio thread
+    void applyCommands() {
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            applying.swap(pending);
+        }
+        for (Command& c : applying) {
+            if (c.kind == Command::Music) {
+                for (Voice& v : musicVoices) {
+                    if (!v.active) continue;
+                    v.stem = -1;
+                    v.stopAtTarget = true;
+                    rampTo(v, 0.f, c.fade);
+                }
+                for (size_t i = 0; i < c.stems.size(); ++i) {
+                    Voice* slot = nullptr;
+                    for (Voice& v : musicVoices) if (!v.active) { slot = &v; break; }
+                    if (!slot) {
+                        // out of voices: cut the quietest fading one
+                        slot = &*std::min_element(musicVoices.begin(), musicVoices.end(),
+                            [](const Voice& a, const Voice& b) { return a.gain < b.gain; });
+                    }
+                    *slot = Voice();
+                    slot->active = true;
+                    slot->stem = (int)i;
+                    slot->stream = std::move(c.stems[i]);
+                    rampTo(*slot, c.gains[i], c.fade);
+                }
+            }
+            else if (c.kind == Command::StemGain) {
+                for (Voice& v : musicVoices)
+                    if (v.active && v.stem == c.stem) rampTo(v, c.gain, c.fade);
+            }
+            else {
+                Voice* slot = nullptr;
+                for (Voice& v : sfxVoices) if (!v.active) { slot = &v; break; }
+                if (!slot) {
+                    slot = &*std::max_element(sfxVoices.begin(), sfxVoices.end(),
+                        [](const Voice& a, const Voice& b) {
+                            return a.clip->frames() - a.pos > b.clip->frames() - b.pos; });
+                }
+                *slot = Voice();
+                slot->active = true;
+                slot->clip = c.clip;
+                slot->gain = slot->target = c.gain;
+            }
+        }
+        applying.clear();
+    }
+
+    bool onGetData(Chunk& data) override {
+        applyCommands();
+
+        const size_t frames = kMixBlockFrames;
+        std::fill(mix.begin(), mix.end(), 0.f);
+
+        for (Voice& v : musicVoices) {
+            if (!v.active) continue;
+            const bool more = v.stream->read(scratch.data(), frames) == frames;
+            v.gain = mixRamp(mix.data(), scratch.data(), frames, v.gain, v.target, v.step);
+            if (!more || (v.stopAtTarget && v.gain == v.target)) {
+                v.active = false;
+                v.stream.reset();
+            }
+        }
+
+        for (Voice& v : sfxVoices) {
+            if (!v.active) continue;
+            const size_t n = std::min(frames, v.clip->frames() - v.pos);
+            v.gain = mixRamp(mix.data(), v.clip->samples.data() + v.pos * 2, n, v.gain, v.target, v.step);
+            v.pos += n;
+            if (v.pos >= v.clip->frames()) v.active = false;
+        }
+
+        mixToPcm16(mix.data(), pcm.data(), frames * 2, master.load(std::memory_order_relaxed));
+        data.samples = pcm.data();
+        data.sampleCount = frames * 2;
+        return true; // the mixer never ends; silence when nothing plays
+    }
+
+    void onSeek(sf::Time) override {}
+
+    std::vector<std::unique_ptr<MixClip>> clips; // game thread (voices only hold raw pointers)
+
+    std::mutex queueMutex;
+    std::vector<Command> pending;  // guarded by queueMutex
+    std::vector<Command> applying; // audio thread
+
+    std::vector<Voice> musicVoices;
+    std::vector<Voice> sfxVoices;
+    std::vector<float> mix, scratch;
+    std::vector<std::int16_t> pcm;
+    std::atomic<float> master{ 1.f };
+};
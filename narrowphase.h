@@ -0,0 +1,344 @@
+#pragma once
+// narrowphase.h
+// - Exact soul-vs-bullet test: bullet circle (its radius) against the heart, not the 14x14 box
+// - The heart is the union of two convex lobes (same 32x28 outline as soulShape, scaled to the hitbox)
+// - firstHeartHit() tests 8 bullets per instruction with AVX (4 with SSE2, scalar fallback)
+//   over SoA bullet arrays and stops at the first block that contains a hit
+// - The build only assumes SSE2: on MSVC x64 the AVX kernel is compiled anyway and picked at
+//   runtime (cpuid), so CPUs without AVX run the SSE2 kernel instead of crashing
+// - runNarrowphaseBench(): `game --bench-narrowphase`, compares against the old AABB intersects() loop
+
+#include <SFML/Graphics.hpp>
+
+#include <vector>
+#include <cstdint>
+#include <cstdlib>
+#include <cfloat>
+#include <cmath>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+
+// MSVC accepts AVX intrinsics without /arch:AVX, so x64 builds carry both kernels
+#if defined(__AVX__) || (defined(_MSC_VER) && defined(_M_X64))
+#define NARROWPHASE_AVX 1
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define NARROWPHASE_SSE 1
+#endif
+#if defined(NARROWPHASE_AVX) || defined(NARROWPHASE_SSE)
+#include <immintrin.h>
+#endif
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// true when the AVX kernel may run: always if the whole build targets AVX, otherwise only
+// if the CPU has AVX and the OS saves the YMM registers
+static bool narrowphaseCpuHasAvx() {
+#if defined(__AVX__)
+    return true;
+#elif defined(NARROWPHASE_AVX) && defined(_MSC_VER)
+    int regs[4];
+    __cpuid(regs, 1);
+    const bool osxsave = (regs[2] & (1 << 27)) != 0;
+    const bool avx = (regs[2] & (1 << 28)) != 0;
+    return osxsave && avx && (_xgetbv(0) & 6) == 6;
+#else
+    return false;
+#endif
+}
+
+struct HeartHitbox {
+    static constexpr int kLobes = 2;
+    static constexpr int kEdges = 4;
+
+    // per edge (lobe-major): start point, edge vector, 1 / |edge|^2
+    float ax[kLobes * kEdges], ay[kLobes * kEdges];
+    float ex[kLobes * kEdges], ey[kLobes * kEdges];
+    float invLen2[kLobes * kEdges];
+
+    sf::Vector2f half; // half of the hitbox, used for the per-block box reject
+
+    // `size` is the soul hitbox (soul.size); coordinates are relative to its top-left
+    void build(sf::Vector2f size) {
+        // soulShape outline in its 32x28 local space, split at the notch into two convex lobes.
+        // Both are wound so that cross(edge, p - start) >= 0 means "inside".
+        static const sf::Vector2f lobes[kLobes][kEdges] = {
+            { { 8.f, 0.f }, { 16.f, 4.f }, { 16.f, 28.f }, { 0.f, 10.f } },
+            { { 16.f, 4.f }, { 24.f, 0.f }, { 32.f, 10.f }, { 16.f, 28.f } }
+        };
+        const float sx = size.x / 32.f;
+        const float sy = size.y / 28.f;
+
+        for (int l = 0; l < kLobes; ++l) {
+            for (int e = 0; e < kEdges; ++e) {
+                sf::Vector2f a = lobes[l][e];
+                sf::Vector2f b = lobes[l][(e + 1) % kEdges];
+                int k = l * kEdges + e;
+                ax[k] = a.x * sx;
+                ay[k] = a.y * sy;
+                ex[k] = (b.x - a.x) * sx;
+                ey[k] = (b.y - a.y) * sy;
+                invLen2[k] = 1.f / (ex[k] * ex[k] + ey[k] * ey[k]);
+            }
+        }
+        half = { size.x / 2.f, size.y / 2.f };
+    }
+};
+
+// reference version, also used for the tail that doesn't fill a SIMD block.
+// (px, py) is the bullet center relative to the hitbox top-left.
+static bool heartHitScalar(const HeartHitbox& h, float px, float py, float r) {
+    for (int l = 0; l < HeartHitbox::kLobes; ++l) {
+        bool inside = true;
+        float best = FLT_MAX;
+        for (int e = 0; e < HeartHitbox::kEdges; ++e) {
+            int k = l * HeartHitbox::kEdges + e;
+            float dx = px - h.ax[k], dy = py - h.ay[k];
+            inside = inside && (h.ex[k] * dy - h.ey[k] * dx >= 0.f);
+            float t = std::min(1.f, std::max(0.f, (dx * h.ex[k] + dy * h.ey[k]) * h.invLen2[k]));
+            float qx = dx - t * h.ex[k], qy = dy - t * h.ey[k];
+            best = std::min(best, qx * qx + qy * qy);
+        }
+        if (inside || best <= r * r) return true;
+    }
+    return false;
+}
+
+// -----------------------------
+// Lane wrappers so one kernel body serves both widths
+// -----------------------------
+#ifdef NARROWPHASE_AVX
+struct LanesAvx {
+    using V = __m256;
+    static constexpr int N = 8;
+    static V load(const float* p) { return _mm256_loadu_ps(p); }
+    static V set1(float v) { return _mm256_set1_ps(v); }
+    static V add(V a, V b) { return _mm256_add_ps(a, b); }
+    static V sub(V a, V b) { return _mm256_sub_ps(a, b); }
+    static V mul(V a, V b) { return _mm256_mul_ps(a, b); }
+    static V vmin(V a, V b) { return _mm256_min_ps(a, b); }
+    static V vmax(V a, V b) { return _mm256_max_ps(a, b); }
+    static V vabs(V a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.f), a); }
+    static V le(V a, V b) { return _mm256_cmp_ps(a, b, _CMP_LE_OQ); }
+    static V ge(V a, V b) { return _mm256_cmp_ps(a, b, _CMP_GE_OQ); }
+    static V vand(V a, V b) { return _mm256_and_ps(a, b); }
+    static V vor(V a, V b) { return _mm256_or_ps(a, b); }
+    static int mask(V a) { return _mm256_movemask_ps(a); }
+};
+#endif
+
+#ifdef NARROWPHASE_SSE
+struct LanesSse {
+    using V = __m128;
+    static constexpr int N = 4;
+    static V load(const float* p) { return _mm_loadu_ps(p); }
+    static V set1(float v) { return _mm_set1_ps(v); }
+    static V add(V a, V b) { return _mm_add_ps(a, b); }
+    static V sub(V a, V b) { return _mm_sub_ps(a, b); }
+    static V mul(V a, V b) { return _mm_mul_ps(a, b); }
+    static V vmin(V a, V b) { return _mm_min_ps(a, b); }
+    static V vmax(V a, V b) { return _mm_max_ps(a, b); }
+    static V vabs(V a) { return _mm_andnot_ps(_mm_set1_ps(-0.f), a); }
+    static V le(V a, V b) { return _mm_cmple_ps(a, b); }
+    static V ge(V a, V b) { return _mm_cmpge_ps(a, b); }
+    static V vand(V a, V b) { return _mm_and_ps(a, b); }
+    static V vor(V a, V b) { return _mm_or_ps(a, b); }
+    static int mask(V a) { return _mm_movemask_ps(a); }
+};
+#endif
+
+// Processes whole blocks of L::N bullets. Returns the first hit index, or -1 and sets
+// `done` to how many bullets were covered (the caller finishes the tail).
+template <class L>
+static int heartKernel(const HeartHitbox& h, float ox, float oy,
+                       const float* xs, const float* ys, const float* rs, size_t n, size_t& done) {
+    using V = typename L::V;
+    const V vox = L::set1(ox), voy = L::set1(oy);
+    const V zero = L::set1(0.f), one = L::set1(1.f);
+    const V hx = L::set1(h.half.x), hy = L::set1(h.half.y);
+
+    size_t i = 0;
+    for (; i + L::N <= n; i += L::N) {
+        V px = L::sub(L::load(xs + i), vox);
+        V py = L::sub(L::load(ys + i), voy);
+        V r = L::load(rs + i);
+
+        // cheap box reject for the whole block first (most bullets are nowhere near the soul)
+        V nearX = L::le(L::vabs(L::sub(px, hx)), L::add(hx, r));
+        V nearY = L::le(L::vabs(L::sub(py, hy)), L::add(hy, r));
+        if (L::mask(L::vand(nearX, nearY)) == 0) continue;
+
+        V r2 = L::mul(r, r);
+        V hit = zero;
+        for (int l = 0; l < HeartHitbox::kLobes; ++l) {
+            V inside = L::le(zero, one); // all lanes true
+            V best = L::set1(FLT_MAX);
+            for (int e = 0; e < HeartHitbox::kEdges; ++e) {
+                const int k = l * HeartHitbox::kEdges + e;
+                const V ex = L::set1(h.ex[k]), ey = L::set1(h.ey[k]);
+                V dx = L::sub(px, L::set1(h.ax[k]));
+                V dy = L::sub(py, L::set1(h.ay[k]));
+
+                inside = L::vand(inside, L::ge(L::sub(L::mul(ex, dy), L::mul(ey, dx)), zero));
+
+                V t = L::mul(L::add(L::mul(dx, ex), L::mul(dy, ey)), L::set1(h.invLen2[k]));
+                t = L::vmin(L::vmax(t, zero), one);
+                V qx = L::sub(dx, L::mul(t, ex));
+                V qy = L::sub(dy, L::mul(t, ey));
+                best = L::vmin(best, L::add(L::mul(qx, qx), L::mul(qy, qy)));
+            }
+            hit = L::vor(hit, L::vor(inside, L::le(best, r2)));
+        }
+
+        int m = L::mask(L::vand(hit, L::vand(nearX, nearY)));
+        if (m) {
+            int lane = 0;
+            while (!((m >> lane) & 1)) ++lane;
+            done = i;
+            return (int)(i + lane);
+        }
+    }
+    done = i;
+    return -1;
+}
+
+// First bullet whose circle touches the heart, or -1. `origin` is the hitbox top-left (soul.pos).
+static int firstHeartHit(const HeartHitbox& h, sf::Vector2f origin,
+                         const float* xs, const float* ys, const float* rs, size_t n) {
+    size_t done = 0;
+#ifdef NARROWPHASE_AVX
+    static const bool useAvx = narrowphaseCpuHasAvx();
+    if (useAvx) {
+        size_t d = 0;
+        int hit = heartKernel<LanesAvx>(h, origin.x, origin.y, xs, ys, rs, n, d);
+        if (hit >= 0) return hit;
+        done = d;
+    }
+#endif
+#ifdef NARROWPHASE_SSE
+    {
+        size_t d = 0;
+        int hit = heartKernel<LanesSse>(h, origin.x, origin.y, xs + done, ys + done, rs + done, n - done, d);
+        if (hit >= 0) return (int)(done + hit);
+        done += d;
+    }
+#endif
+    for (; done < n; ++done) {
+        if (heartHitScalar(h, xs[done] - origin.x, ys[done] - origin.y, rs[done])) return (int)done;
+    }
+    return -1;
+}
+
+// SoA scratch the bullets are gathered into before the kernel runs
+struct BulletCandidates {
+    std::vector<float> x, y, r;
+
+    void clear() { x.clear(); y.clear(); r.clear(); }
+    void resize(size_t n) { x.resize(n); y.resize(n); r.resize(n); }
+    void set(size_t i, sf::Vector2f pos, float radius) {
+        x[i] = pos.x;
+        y[i] = pos.y;
+        r[i] = radius;
+    }
+    void push(sf::Vector2f pos, float radius) {
+        x.push_back(pos.x);
+        y.push_back(pos.y);
+        r.push_back(radius);
+    }
+    size_t size() const { return x.size(); }
+};
+
+// -----------------------------
+// Benchmark: old AABB loop vs heart kernel
+// -----------------------------
+static void runNarrowphaseBench() {
+    using Clock = std::chrono::steady_clock;
+
+    const sf::FloatRect box({ 260.f, 140.f }, { 380.f, 240.f }); // battleBox
+    const sf::Vector2f soulSize{ 14.f, 14.f };
+    const sf::Vector2f soulPos{ box.position.x + box.size.x / 2.f - 7.f, box.position.y + box.size.y / 2.f - 7.f };
+
+    HeartHitbox heart;
+    heart.build(soulSize);
+
+    std::cout << "narrowphase: soul vs N bullets, worst case (no hit, full scan)\n";
+    std::cout << std::setw(8) << "bullets" << std::setw(14) << "aabb ns/blt"
+              << std::setw(14) << "heart ns/blt" << std::setw(10) << "speedup"
+              << std::setw(14) << "kernel ns/blt"
+              << std::setw(14) << "aabb hits" << std::setw(14) << "heart hits" << "\n";
+
+    for (size_t count : { 64u, 256u, 1024u, 4096u, 16384u }) {
+        struct B { sf::Vector2f pos; float r; };
+        std::vector<B> bullets(count);
+        BulletCandidates soa;
+
+        // miss set: keep every bullet out of the soul's box so both sides scan everything
+        for (auto& b : bullets) {
+            b.r = 6.f;
+            do {
+                b.pos = { box.position.x + (float)(rand() % (int)box.size.x),
+                          box.position.y + (float)(rand() % (int)box.size.y) };
+            } while (std::fabs(b.pos.x - (soulPos.x + 7.f)) < 7.f + b.r + 1.f &&
+                     std::fabs(b.pos.y - (soulPos.y + 7.f)) < 7.f + b.r + 1.f);
+            soa.push(b.pos, b.r);
+        }
+
+        const int reps = (int)std::max<size_t>(50, 2000000 / count);
+        sf::FloatRect sr(soulPos, soulSize);
+
+        volatile int sink = 0;
+        auto t0 = Clock::now();
+        for (int rep = 0; rep < reps; ++rep) {
+            for (auto& b : bullets) {
+                sf::FloatRect br({ b.pos.x - b.r, b.pos.y - b.r }, { b.r * 2.f, b.r * 2.f });
+                if (sr.findIntersection(br).has_value()) { sink = sink + 1; break; }
+            }
+        }
+        auto t1 = Clock::now();
+        for (int rep = 0; rep < reps; ++rep) {
+            soa.resize(bullets.size());
+            for (size_t i = 0; i < bullets.size(); ++i) soa.set(i, bullets[i].pos, bullets[i].r); // gather is part of the cost
+            if (firstHeartHit(heart, soulPos, soa.x.data(), soa.y.data(), soa.r.data(), soa.size()) >= 0) sink = sink + 1;
+        }
+        auto t2 = Clock::now();
+        for (int rep = 0; rep < reps; ++rep) {
+            if (firstHeartHit(heart, soulPos, soa.x.data(), soa.y.data(), soa.r.data(), soa.size()) >= 0) sink = sink + 1;
+        }
+        auto t3 = Clock::now();
+
+        // accuracy on a hit-heavy random field: how many AABB hits the heart rejects
+        size_t aabbHits = 0, heartHits = 0;
+        for (int s = 0; s < 20000; ++s) {
+            float px = (float)(rand() % 3200) / 100.f - 9.f; // -9..23 around the 14px box
+            float py = (float)(rand() % 3200) / 100.f - 9.f;
+            float r = 6.f;
+            sf::FloatRect br({ soulPos.x + px - r, soulPos.y + py - r }, { r * 2.f, r * 2.f });
+            if (sr.findIntersection(br).has_value()) ++aabbHits;
+            if (heartHitScalar(heart, px, py, r)) ++heartHits;
+        }
+
+        double aabbNs = std::chrono::duration<double, std::nano>(t1 - t0).count() / ((double)reps * count);
+        double heartNs = std::chrono::duration<double, std::nano>(t2 - t1).count() / ((double)reps * count);
+        double kernelNs = std::chrono::duration<double, std::nano>(t3 - t2).count() / ((double)reps * count);
+        std::cout << std::setw(8) << count
+                  << std::setw(14) << std::fixed << std::setprecision(3) << aabbNs
+                  << std::setw(14) << heartNs
+                  << std::setw(9) << std::setprecision(2) << (heartNs > 0.0 ? aabbNs / heartNs : 0.0) << "x"
+                  << std::setw(14) << std::setprecision(3) << kernelNs
+                  << std::setw(14) << aabbHits
+                  << std::setw(14) << heartHits << "\n";
+        (void)sink;
+    }
+#if defined(NARROWPHASE_AVX)
+    if (narrowphaseCpuHasAvx()) std::cout << "kernel: AVX, 8 bullets per instruction\n";
+    else
+#endif
+#if defined(NARROWPHASE_SSE)
+    std::cout << "kernel: SSE2, 4 bullets per instruction\n";
+#else
+    std::cout << "kernel: scalar fallback\n";
+#endif
+}
@@ -0,0 +1,155 @@
+#pragma once
+// particles.h
+// - CPU particle pool for hit sparks, damage bursts and the enemy dissolve
+// - Particles are stored SoA (one array per attribute) so update() is a set of
+//   flat float loops the compiler can vectorize
+// - All live particles are written into one vertex buffer and drawn with ONE draw call
+
+#include <SFML/Graphics.hpp>
+
+#include <vector>
+#include <cstdint>
+#include <cstdlib>
+#include <cmath>
+#include <algorithm>
+
+static float randRange(float lo, float hi) {
+    return lo + (hi - lo) * ((float)rand() / (float)RAND_MAX);
+}
+
+struct ParticlePool {
+    explicit ParticlePool(size_t capacity) : cap(capacity) {
+        x.resize(cap); y.resize(cap);
+        vx.resize(cap); vy.resize(cap);
+        ay.resize(cap);
+        delay.resize(cap);
+        life.resize(cap); invMaxLife.resize(cap);
+        size.resize(cap);
+        color.resize(cap);
+        verts.resize(cap * 6);
+    }
+
+    size_t count() const { return n; }
+    bool empty() const { return n == 0; }
+    void clear() { n = 0; }
+
+    // single particle; silently dropped when the pool is full. A delayed particle is drawn
+    // where it was emitted and only starts moving (and aging) after `delaySec`
+    void emit(sf::Vector2f pos, sf::Vector2f vel, float lifeSec, float sz, sf::Color c, float accelY = 0.f,
+              float delaySec = 0.f) {
+        if (n >= cap || lifeSec <= 0.f) return;
+        x[n] = pos.x; y[n] = pos.y;
+        vx[n] = vel.x; vy[n] = vel.y;
+        ay[n] = accelY;
+        delay[n] = std::max(0.f, delaySec);
+        life[n] = lifeSec; invMaxLife[n] = 1.f / lifeSec;
+        size[n] = sz;
+        color[n] = c;
+        ++n;
+    }
+
+    // radial burst around a point (soul hit sparks, damage burst)
+    void emitBurst(sf::Vector2f at, int amount, float speedMin, float speedMax,
+                   float lifeMin, float lifeMax, float sz, sf::Color c, float accelY = 0.f) {
+        for (int i = 0; i < amount; ++i) {
+            float a = randRange(0.f, 6.2831853f);
+            float s = randRange(speedMin, speedMax);
+            emit(at, { std::cos(a) * s, std::sin(a) * s }, randRange(lifeMin, lifeMax), sz, c, accelY);
+        }
+    }
+
+    // break an image into particles: one particle per `step` source pixels, colored by the image
+    // (used for the EnemyDefeated dissolve; `center` / `scale` match how the sprite is drawn)
+    void emitDissolve(const sf::Image& img, sf::Vector2f center, float scale, unsigned step,
+                      float lifeMin, float lifeMax) {
+        sf::Vector2u is = img.getSize();
+        if (step == 0) step = 1;
+        sf::Vector2f topLeft = { center.x - is.x * scale / 2.f, center.y - is.y * scale / 2.f };
+        float sz = std::max(1.f, step * scale);
+
+        for (unsigned py = 0; py < is.y; py += step) {
+            for (unsigned px = 0; px < is.x; px += step) {
+                sf::Color c = img.getPixel({ px, py });
+                if (c.a < 16) continue;
+                sf::Vector2f pos = { topLeft.x + px * scale, topLeft.y + py * scale };
+                // rows near the top go first so the sprite crumbles from the top down
+                float start = 0.6f * (float)py / (float)is.y;
+                sf::Vector2f vel = { randRange(-30.f, 30.f), randRange(-60.f, -10.f) };
+                emit(pos, vel, randRange(lifeMin, lifeMax), sz, c, -40.f, start);
+            }
+        }
+    }
+
+    void update(float dt) {
+        float* px = x.data();
+        float* py = y.data();
+        float* pvx = vx.data();
+        float* pvy = vy.data();
+        const float* pay = ay.data();
+        float* pd = delay.data();
+        float* pl = life.data();
+
+        // straight SoA kernels: no branches, vectorizable. A particle only advances by the part
+        // of dt left after its start delay, so delayed ones hold still until their turn
+        for (size_t i = 0; i < n; ++i) pvy[i] += pay[i] * std::max(0.f, dt - pd[i]);
+        for (size_t i = 0; i < n; ++i) px[i] += pvx[i] * std::max(0.f, dt - pd[i]);
+        for (size_t i = 0; i < n; ++i) py[i] += pvy[i] * std::max(0.f, dt - pd[i]);
+        for (size_t i = 0; i < n; ++i) pl[i] -= std::max(0.f, dt - pd[i]);
+        for (size_t i = 0; i < n; ++i) pd[i] = std::max(0.f, pd[i] - dt);
+
+        // compact: swap the last live particle into each dead slot
+        size_t i = 0;
+        while (i < n) {
+            if (pl[i] > 0.f) { ++i; continue; }
+            --n;
+            x[i] = x[n]; y[i] = y[n];
+            vx[i] = vx[n]; vy[i] = vy[n];
+            ay[i] = ay[n];
+            delay[i] = delay[n];
+            life[i] = life[n]; invMaxLife[i] = invMaxLife[n];
+            size[i] = size[n];
+            color[i] = color[n];
+        }
+    }
+
+    // returns the number of draw calls issued (0 or 1)
+    unsigned draw(sf::RenderTarget& target) {
+        if (n == 0) return 0;
+
+        for (size_t i = 0; i < n; ++i) {
+            float k = life[i] * invMaxLife[i];              // 1 -> 0 over lifetime
+            k = std::min(1.f, std::max(0.f, k));
+            float h = size[i] * (0.5f + 0.5f * k) * 0.5f;   // shrink while fading
+
+            sf::Color c = color[i];
+            c.a = (std::uint8_t)(c.a * k);
+
+            sf::Vector2f a = { x[i] - h, y[i] - h };
+            sf::Vector2f b = { x[i] + h, y[i] - h };
+            sf::Vector2f d = { x[i] - h, y[i] + h };
+            sf::Vector2f e = { x[i] + h, y[i] + h };
+
+            sf::Vertex* v = &verts[i * 6];
+            // untextured: texCoords spelled out so -Wextra stays quiet
+            const sf::Vector2f t = { 0.f, 0.f };
+            v[0] = { a, c, t }; v[1] = { b, c, t }; v[2] = { d, c, t };
+            v[3] = { b, c, t }; v[4] = { e, c, t }; v[5] = { d, c, t };
+        }
+
+        target.draw(verts.data(), n * 6, sf::PrimitiveType::Triangles);
+        return 1;
+    }
+
+    size_t cap = 0;
+    size_t n = 0;
+
+    std::vector<float> x, y;
+    std::vector<float> vx, vy;
+    std::vector<float> ay;
+    std::vector<float> delay;
+    std::vector<float> life, invMaxLife;
+    std::vector<float> size;
+    std::vector<sf::Color> color;
+
+    std::vector<sf::Vertex> verts;
+};
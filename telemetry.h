@@ -0,0 +1,270 @@
+#pragma once
+// telemetry.h
+// - Gameplay telemetry: spawns, soul hits, mode/phase changes, battleTime, frame times
+// - The game thread writes 16-byte records into a lock-free single-producer/single-consumer ring
+//   (a few stores and one release; never blocks, drops and counts records if the ring is full)
+// - A background thread drains the ring into telemetry/<session>_<n>.bin, rotating files by size;
+//   the newest kMaxFiles files are kept across sessions (older runs' files are pruned first)
+// - decodeTelemetry(): `game --decode-telemetry file.bin [out.csv]` turns a file into CSV
+
+#include <vector>
+#include <string>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <filesystem>
+#include <algorithm>
+
+enum class TelemetryType : std::uint8_t {
+    Frame = 1,      // mode, raw frame time (ms)
+    ModeChange = 2, // new mode, battleTime when it happened
+    Spawn = 3,      // battleStage | bullet kind << 8, x, vy
+    SoulHit = 4,    // hp after the hit, battleTime
+    Dropped = 5,    // written by the flusher: records lost because the ring was full
+};
+
+#pragma pack(push, 1)
+struct TelemetryRecord {
+    std::uint32_t timeMs = 0;  // since session start
+    std::uint8_t type = 0;     // TelemetryType
+    std::uint8_t mode = 0;     // GameMode at the time
+    std::uint16_t i0 = 0;      // small int payload (stage + kind / hp / count)
+    float f0 = 0.f;
+    float f1 = 0.f;
+};
+
+struct TelemetryFileHeader {
+    char magic[4] = { 'L', 'T', 'T', 'L' };
+    std::uint16_t version = 1;
+    std::uint16_t recordSize = sizeof(TelemetryRecord);
+    std::int64_t sessionStart = 0; // unix seconds
+};
+#pragma pack(pop)
+
+static_assert(sizeof(TelemetryRecord) == 16, "telemetry records are 16 bytes on disk");
+
+class Telemetry {
+public:
+    static constexpr size_t kCapacity = 1 << 15; // records (512 KB), power of two
+    static constexpr std::uint64_t kMaxFileBytes = 4ull << 20;
+    static constexpr int kMaxFiles = 8;
+
+    Telemetry() : ring(kCapacity) {}
+    Telemetry(const Telemetry&) = delete;
+    Telemetry& operator=(const Telemetry&) = delete;
+    ~Telemetry() { stop(); }
+
+    bool start(const std::filesystem::path& directory) {
+        if (running.load()) return true;
+
+        std::error_code ec;
+        std::filesystem::create_directories(directory, ec);
+        if (ec) {
+            std::cerr << "ERROR: couldn't create telemetry dir " << directory.string() << "\n";
+            return false;
+        }
+        dir = directory;
+        sessionStart = (std::int64_t)std::time(nullptr);
+        fileIndex = 0;
+        findExistingFiles();
+
+        running.store(true);
+        flusher = std::thread([this]() { flushLoop(); });
+        return true;
+    }
+
+    void stop() {
+        if (!running.exchange(false)) return;
+        if (flusher.joinable()) flusher.join();
+    }
+
+    // game thread: cached once per frame so record() doesn't touch the clock
+    void setTime(std::uint32_t ms, std::uint8_t currentMode) {
+        nowMs = ms;
+        mode = currentMode;
+    }
+
+    // game thread only (single producer)
+    bool record(TelemetryType type, std::uint16_t i0 = 0, float f0 = 0.f, float f1 = 0.f) {
+        const size_t h = head.load(std::memory_order_relaxed);
+        if (h - tail.load(std::memory_order_acquire) >= kCapacity) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        TelemetryRecord& r = ring[h & (kCapacity - 1)];
+        r.timeMs = nowMs;
+        r.type = (std::uint8_t)type;
+        r.mode = mode;
+        r.i0 = i0;
+        r.f0 = f0;
+        r.f1 = f1;
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    void flushLoop() {
+        std::ofstream out;
+        std::uint64_t written = 0;
+        std::uint32_t lastMs = 0; // time of the newest record seen, stamps Dropped records
+
+        for (;;) {
+            const bool last = !running.load();
+
+            size_t t = tail.load(std::memory_order_relaxed);
+            const size_t h = head.load(std::memory_order_acquire);
+            std::uint32_t lost = dropped.exchange(0, std::memory_order_relaxed);
+
+            if (h != t || lost) {
+                if (!out.is_open() || written >= kMaxFileBytes) {
+                    out.close();
+                    openNext(out);
+                    written = sizeof(TelemetryFileHeader);
+                }
+                if (out.is_open()) {
+                    // at most two contiguous spans (before and after the wrap)
+                    while (t != h) {
+                        size_t at = t & (kCapacity - 1);
+                        size_t span = std::min(h - t, kCapacity - at);
+                        out.write((const char*)&ring[at], (std::streamsize)(span * sizeof(TelemetryRecord)));
+                        written += span * sizeof(TelemetryRecord);
+                        t += span;
+                    }
+                    if (h != tail.load(std::memory_order_relaxed)) lastMs = ring[(h - 1) & (kCapacity - 1)].timeMs;
+                    if (lost) {
+                        TelemetryRecord r;
+                        r.timeMs = lastMs;
+                        r.type = (std::uint8_t)TelemetryType::Dropped;
+                        r.i0 = (std::uint16_t)std::min<std::uint32_t>(lost, 0xFFFF);
+                        out.write((const char*)&r, sizeof(r));
+                        written += sizeof(r);
+                    }
+                    out.flush();
+                }
+                tail.store(h, std::memory_order_release);
+            }
+
+            if (last) break;
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+    }
+
+    // files left by earlier sessions, oldest first, so openNext() prunes them before this run's
+    void findExistingFiles() {
+        struct Found { long long session; int index; std::filesystem::path path; };
+        std::vector<Found> found;
+        std::error_code ec;
+        for (auto& de : std::filesystem::directory_iterator(dir, ec)) {
+            long long session = 0;
+            int index = 0;
+            char tail = 0;
+            std::string name = de.path().filename().string();
+            if (de.is_regular_file() && std::sscanf(name.c_str(), "%lld_%d.bi%c", &session, &index, &tail) == 3 && tail == 'n')
+                found.push_back({ session, index, de.path() });
+        }
+        std::sort(found.begin(), found.end(), [](const Found& a, const Found& b) {
+            return a.session != b.session ? a.session < b.session : a.index < b.index;
+            });
+
+        files.clear();
+        for (const Found& f : found) files.push_back(f.path);
+    }
+
+    void openNext(std::ofstream& out) {
+        char name[64];
+        std::snprintf(name, sizeof(name), "%lld_%03d.bin", (long long)sessionStart, fileIndex);
+        std::filesystem::path path = dir / name;
+        ++fileIndex;
+
+        out.open(path, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            std::cerr << "ERROR: couldn't write telemetry file " << path.string() << "\n";
+            return;
+        }
+        TelemetryFileHeader header;
+        header.sessionStart = sessionStart;
+        out.write((const char*)&header, sizeof(header));
+
+        files.push_back(path);
+        while ((int)files.size() > kMaxFiles) {
+            std::error_code ec;
+            std::filesystem::remove(files.front(), ec);
+            files.erase(files.begin());
+        }
+    }
+
+    std::vector<TelemetryRecord> ring;
+    alignas(64) std::atomic<size_t> head{ 0 };  // written by the game thread
+    alignas(64) std::atomic<size_t> tail{ 0 };  // written by the flusher
+    alignas(64) std::atomic<std::uint32_t> dropped{ 0 };
+
+    // game thread only
+    std::uint32_t nowMs = 0;
+    std::uint8_t mode = 0;
+
+    std::atomic<bool> running{ false };
+    std::thread flusher;
+    std::filesystem::path dir;
+    std::int64_t sessionStart = 0;
+    int fileIndex = 0;
+    std::vector<std::filesystem::path> files;
+};
+
+// -----------------------------
+// Offline decoder: binary telemetry -> CSV
+// -----------------------------
+static bool decodeTelemetry(const std::filesystem::path& in, std::ostream& csv, const char* const* modeNames, int modeCount,
+                            const char* const* kindNames, int kindCount) {
+    std::ifstream file(in, std::ios::binary);
+    TelemetryFileHeader header;
+    if (!file.read((char*)&header, sizeof(header)) || std::string(header.magic, 4) != "LTTL") {
+        std::cerr << "ERROR: not a telemetry file: " << in.string() << "\n";
+        return false;
+    }
+    if (header.version != 1 || header.recordSize != sizeof(TelemetryRecord)) {
+        std::cerr << "ERROR: unsupported telemetry version in " << in.string() << "\n";
+        return false;
+    }
+
+    auto modeName = [&](int m) -> std::string {
+        return (m >= 0 && m < modeCount) ? modeNames[m] : std::to_string(m);
+        };
+    auto kindName = [&](int k) -> std::string {
+        return (k >= 0 && k < kindCount) ? kindNames[k] : std::to_string(k);
+        };
+
+    csv << "session,t_ms,event,mode,stage,x,vy,hp,battle_time,frame_ms,dropped,kind\n";
+
+    TelemetryRecord r;
+    while (file.read((char*)&r, sizeof(r))) {
+        csv << header.sessionStart << "," << r.timeMs << ",";
+        switch ((TelemetryType)r.type) {
+        case TelemetryType::Frame:
+            csv << "frame," << modeName(r.mode) << ",,,,,," << r.f0 << ",,\n";
+            break;
+        case TelemetryType::ModeChange:
+            csv << "mode," << modeName(r.i0) << ",,,,," << r.f0 << ",,,\n";
+            break;
+        case TelemetryType::Spawn:
+            // files from before bullet kinds have kind 0 (straight) here
+            csv << "spawn," << modeName(r.mode) << "," << (r.i0 & 0xFF) << "," << r.f0 << "," << r.f1 << ",,,,,"
+                << kindName(r.i0 >> 8) << "\n";
+            break;
+        case TelemetryType::SoulHit:
+            csv << "hit," << modeName(r.mode) << ",,,," << r.i0 << "," << r.f0 << ",,,\n";
+            break;
+        case TelemetryType::Dropped:
+            csv << "dropped,,,,,,,," << r.i0 << ",\n";
+            break;
+        default:
+            csv << "unknown(" << (int)r.type << "),,,,,,,,,\n";
+            break;
+        }
+    }
+    return true;
+}
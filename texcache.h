@@ -0,0 +1,205 @@
+#pragma once
+// texcache.h
+// - Loads images at the size they actually cover on the canvas, not the size they were authored at
+//   (enemy.jpeg ends up at 0.125x, the walk frames at ~25x25 canvas pixels out of 370x511)
+// - The first run decodes the source, box-filters it down, and stores the raw RGBA result in
+//   cache/textures.bin; later runs read that one file and skip the decode entirely
+// - The key is the pack's content hash of the source (computed at pack time), so editing an asset
+//   and repacking invalidates it without hashing anything at startup
+
+#include <SFML/Graphics.hpp>
+
+#include "assetpack.h"
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <filesystem>
+#include <algorithm>
+#include <utility>
+
+// Area-average downscale (premultiplied, so transparent pixels don't darken the edges).
+// Also handles upscaling by falling back to nearest sampling, though nothing uses that.
+static sf::Image resizeImageBox(const sf::Image& src, sf::Vector2u dstSize) {
+    const sf::Vector2u ss = src.getSize();
+    if (dstSize.x == 0) dstSize.x = 1;
+    if (dstSize.y == 0) dstSize.y = 1;
+
+    const std::uint8_t* sp = src.getPixelsPtr();
+    std::vector<std::uint8_t> out((size_t)dstSize.x * dstSize.y * 4);
+
+    const double fx = (double)ss.x / dstSize.x;
+    const double fy = (double)ss.y / dstSize.y;
+
+    for (unsigned y = 0; y < dstSize.y; ++y) {
+        unsigned y0 = (unsigned)(y * fy);
+        unsigned y1 = std::max(y0 + 1, std::min(ss.y, (unsigned)std::ceil((y + 1) * fy)));
+        for (unsigned x = 0; x < dstSize.x; ++x) {
+            unsigned x0 = (unsigned)(x * fx);
+            unsigned x1 = std::max(x0 + 1, std::min(ss.x, (unsigned)std::ceil((x + 1) * fx)));
+
+            std::uint64_t r = 0, g = 0, b = 0, a = 0, n = 0;
+            for (unsigned sy = y0; sy < y1; ++sy) {
+                const std::uint8_t* row = sp + ((size_t)sy * ss.x) * 4;
+                for (unsigned sx = x0; sx < x1; ++sx) {
+                    const std::uint8_t* px = row + (size_t)sx * 4;
+                    r += (std::uint64_t)px[0] * px[3];
+                    g += (std::uint64_t)px[1] * px[3];
+                    b += (std::uint64_t)px[2] * px[3];
+                    a += px[3];
+                    ++n;
+                }
+            }
+
+            std::uint8_t* d = &out[((size_t)y * dstSize.x + x) * 4];
+            if (a > 0) {
+                d[0] = (std::uint8_t)(r / a);
+                d[1] = (std::uint8_t)(g / a);
+                d[2] = (std::uint8_t)(b / a);
+            }
+            d[3] = (std::uint8_t)(a / n);
+        }
+    }
+    return sf::Image(dstSize, out.data());
+}
+
+// All resized images live in ONE file, read once at startup. Entries are keyed by the pack's
+// content hash of the source plus the requested size, so nothing is hashed or stat'ed per asset.
+// save() rewrites the file only when something was added, keeping just the entries used this run
+// (so stale sizes / edited assets drop out instead of piling up).
+class TextureCache {
+public:
+    explicit TextureCache(std::filesystem::path cacheFile) : path(std::move(cacheFile)) {
+        std::ifstream in(path, std::ios::binary);
+        if (!in) return;
+
+        FileHeader h;
+        if (!in.read((char*)&h, sizeof(h)) || std::string(h.magic, 4) != "LTTC" || h.version != 1) return;
+
+        for (std::uint32_t i = 0; i < h.count; ++i) {
+            EntryHeader e;
+            if (!in.read((char*)&e, sizeof(e)) || e.width == 0 || e.height == 0 || e.width > 16384 || e.height > 16384) break;
+            Entry entry;
+            entry.key = e.key;
+            entry.size = { e.width, e.height };
+            entry.pixels.resize((size_t)e.width * e.height * 4);
+            if (!in.read((char*)entry.pixels.data(), (std::streamsize)entry.pixels.size())) break;
+            entries.push_back(std::move(entry));
+        }
+    }
+
+    static std::uint64_t key(AssetView src, sf::Vector2f scale, sf::Vector2u size) {
+        struct { std::uint64_t source; std::uint32_t w, h; float sx, sy; } k = { src.hash, size.x, size.y, scale.x, scale.y };
+        return fnv1a64(&k, sizeof(k));
+    }
+
+    bool find(std::uint64_t k, sf::Image& out) {
+        for (Entry& e : entries) {
+            if (e.key != k) continue;
+            e.used = true;
+            out = sf::Image(e.size, e.pixels.data());
+            return true;
+        }
+        return false;
+    }
+
+    void put(std::uint64_t k, const sf::Image& img) {
+        Entry e;
+        e.key = k;
+        e.size = img.getSize();
+        e.pixels.assign(img.getPixelsPtr(), img.getPixelsPtr() + (size_t)e.size.x * e.size.y * 4);
+        e.used = true;
+        entries.push_back(std::move(e));
+        dirty = true;
+    }
+
+    // call once loading is done
+    void save() {
+        if (!dirty) return;
+        dirty = false;
+
+        std::error_code ec;
+        std::filesystem::create_directories(path.parent_path(), ec);
+
+        // write to a temp name and rename, so a crash never leaves a half-written cache
+        std::filesystem::path tmp = path;
+        tmp += ".tmp";
+        {
+            std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+            if (!out) return;
+            FileHeader h;
+            for (const Entry& e : entries) h.count += e.used ? 1 : 0;
+            out.write((const char*)&h, sizeof(h));
+            for (const Entry& e : entries) {
+                if (!e.used) continue;
+                EntryHeader eh{ e.key, e.size.x, e.size.y };
+                out.write((const char*)&eh, sizeof(eh));
+                out.write((const char*)e.pixels.data(), (std::streamsize)e.pixels.size());
+            }
+            if (!out) return;
+        }
+        std::filesystem::rename(tmp, path, ec);
+        if (ec) std::filesystem::remove(tmp, ec);
+    }
+
+private:
+    struct FileHeader {
+        char magic[4] = { 'L', 'T', 'T', 'C' };
+        std::uint32_t version = 1;
+        std::uint32_t count = 0;
+        std::uint32_t reserved = 0;
+    };
+    struct EntryHeader {
+        std::uint64_t key;
+        std::uint32_t width;
+        std::uint32_t height;
+    };
+    struct Entry {
+        std::uint64_t key = 0;
+        sf::Vector2u size;
+        std::vector<std::uint8_t> pixels;
+        bool used = false;
+    };
+
+    std::filesystem::path path;
+    std::vector<Entry> entries;
+    bool dirty = false;
+};
+
+// Decoded + resized image for `src`. Target is `size` if non-zero, else the source size times `scale`.
+static bool loadCachedImage(AssetView src, sf::Vector2f scale, sf::Vector2u size, TextureCache& cache, sf::Image& out) {
+    if (!src) return false;
+
+    const std::uint64_t k = TextureCache::key(src, scale, size);
+    if (cache.find(k, out)) return true;
+
+    sf::Image full;
+    if (!full.loadFromMemory(src.data, src.size)) return false;
+
+    sf::Vector2u target = size;
+    if (target.x == 0 || target.y == 0) {
+        target = { (unsigned)std::lround(full.getSize().x * scale.x), (unsigned)std::lround(full.getSize().y * scale.y) };
+    }
+
+    out = (target == full.getSize()) ? full : resizeImageBox(full, target);
+    cache.put(k, out);
+    return true;
+}
+
+// Texture version. `mipmap` is for textures whose draw scale changes at runtime (smooth + mip chain).
+static bool loadCachedTexture(AssetView src, sf::Vector2f scale, sf::Vector2u size, bool mipmap,
+                              TextureCache& cache, sf::Texture& tex, sf::Image* keepImage = nullptr) {
+    sf::Image img;
+    if (!loadCachedImage(src, scale, size, cache, img)) return false;
+    if (!tex.loadFromImage(img)) return false;
+
+    if (mipmap) {
+        tex.setSmooth(true);
+        if (!tex.generateMipmap()) std::cerr << "WARNING: couldn't generate mipmaps\n";
+    }
+    if (keepImage) *keepImage = std::move(img);
+    return true;
+}
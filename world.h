@@ -0,0 +1,491 @@
+#pragma once
+// world.h
+// - The overworld lives on disk as fixed-size square chunks: world/<cx>_<cy>.chunk holds the tile
+//   layer, collision rects and triggers inside that square; world/world.bin holds the map size
+// - ChunkStreamer keeps the chunks around the player resident. A background thread reads them and
+//   builds their tile vertices; the game thread adopts finished chunks with try_lock, so it never
+//   waits on disk. Chunks nobody wants anymore stay cached until the memory budget is exceeded,
+//   then the farthest ones are evicted first
+// - bakeWorld(): `game --bake-world [dir] [roomsX roomsY]` stamps the hand-made room out as chunks
+
+#include <SFML/Graphics.hpp>
+
+#include <vector>
+#include <deque>
+#include <memory>
+#include <string>
+#include <thread>
+#include <chrono>
+#include <optional>
+#include <iterator>
+#include <mutex>
+#include <condition_variable>
+#include <unordered_map>
+#include <cstdint>
+#include <cstdio>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <filesystem>
+#include <algorithm>
+
+static constexpr int kChunkPx = 256;
+static constexpr int kTilePx = 16;
+static constexpr int kChunkTiles = kChunkPx / kTilePx;
+
+enum class TriggerKind : std::uint32_t { Encounter = 1 };
+
+// tile ids: 0 = void (not drawn), 1 = floor, 2 = floor speckle (so scrolling is visible)
+static const sf::Color kTilePalette[] = {
+    sf::Color::Transparent, sf::Color(20, 22, 26), sf::Color(25, 27, 32)
+};
+
+#pragma pack(push, 1)
+struct WorldFileHeader {
+    char magic[4] = { 'L', 'T', 'W', 'D' };
+    std::uint16_t version = 1;
+    std::uint16_t chunkPx = kChunkPx;
+    std::int32_t chunksX = 0;
+    std::int32_t chunksY = 0;
+    float width = 0.f;   // playable size in pixels
+    float height = 0.f;
+};
+
+struct ChunkFileHeader {
+    char magic[4] = { 'L', 'T', 'C', 'H' };
+    std::uint16_t version = 1;
+    std::uint16_t tilePx = kTilePx;
+    std::int32_t cx = 0;
+    std::int32_t cy = 0;
+    std::uint32_t wallCount = 0;    // then wallCount ChunkRect
+    std::uint32_t triggerCount = 0; // then triggerCount ChunkTriggerRecord
+};                                  // tiles (kChunkTiles^2 bytes) follow the header
+
+struct ChunkRect { float x, y, w, h; };
+struct ChunkTriggerRecord { ChunkRect rect; std::uint32_t kind; };
+#pragma pack(pop)
+
+struct WorldTrigger {
+    sf::FloatRect rect;
+    TriggerKind kind = TriggerKind::Encounter;
+};
+
+struct WorldChunk {
+    sf::Vector2i coord;
+    std::vector<std::uint8_t> tiles;
+    std::vector<sf::FloatRect> walls;     // world coordinates, clipped to this chunk
+    std::vector<WorldTrigger> triggers;   // stored in the chunk that holds their center
+    std::vector<sf::Vertex> verts;        // tile layer, built by the loader thread
+    bool failed = false;                  // file missing or corrupt: resident, but solid
+
+    size_t bytes() const {
+        return sizeof(*this) + tiles.capacity() + walls.capacity() * sizeof(sf::FloatRect) +
+               triggers.capacity() * sizeof(WorldTrigger) + verts.capacity() * sizeof(sf::Vertex);
+    }
+};
+
+static std::filesystem::path chunkPath(const std::filesystem::path& dir, sf::Vector2i c) {
+    char name[48];
+    std::snprintf(name, sizeof(name), "%d_%d.chunk", c.x, c.y);
+    return dir / name;
+}
+
+static bool readChunk(const std::filesystem::path& path, sf::Vector2i coord, WorldChunk& out) {
+    out = WorldChunk();
+    out.coord = coord;
+    out.tiles.assign((size_t)kChunkTiles * kChunkTiles, 0);
+
+    std::ifstream in(path, std::ios::binary);
+    ChunkFileHeader h;
+    if (!in.read((char*)&h, sizeof(h)) || std::string(h.magic, 4) != "LTCH" || h.version != 1 ||
+        h.tilePx != kTilePx || h.cx != coord.x || h.cy != coord.y ||
+        h.wallCount > 65536 || h.triggerCount > 65536)
+        return false;
+
+    if (!in.read((char*)out.tiles.data(), (std::streamsize)out.tiles.size())) return false;
+
+    for (std::uint32_t i = 0; i < h.wallCount; ++i) {
+        ChunkRect r;
+        if (!in.read((char*)&r, sizeof(r))) return false;
+        out.walls.push_back(sf::FloatRect({ r.x, r.y }, { r.w, r.h }));
+    }
+    for (std::uint32_t i = 0; i < h.triggerCount; ++i) {
+        ChunkTriggerRecord t;
+        if (!in.read((char*)&t, sizeof(t))) return false;
+        out.triggers.push_back({ sf::FloatRect({ t.rect.x, t.rect.y }, { t.rect.w, t.rect.h }), (TriggerKind)t.kind });
+    }
+
+    // tile quads in world space, one triangle list per chunk
+    const float ox = (float)(coord.x * kChunkPx), oy = (float)(coord.y * kChunkPx);
+    for (int ty = 0; ty < kChunkTiles; ++ty) {
+        for (int tx = 0; tx < kChunkTiles; ++tx) {
+            std::uint8_t id = out.tiles[(size_t)ty * kChunkTiles + tx];
+            if (id == 0 || id >= std::size(kTilePalette)) continue;
+            sf::Color c = kTilePalette[id];
+            sf::Vector2f a = { ox + tx * kTilePx, oy + ty * kTilePx };
+            sf::Vector2f b = { a.x + kTilePx, a.y };
+            sf::Vector2f d = { a.x, a.y + kTilePx };
+            sf::Vector2f e = { a.x + kTilePx, a.y + kTilePx };
+            const sf::Vector2f t = { 0.f, 0.f }; // untextured
+            out.verts.push_back({ a, c, t }); out.verts.push_back({ b, c, t }); out.verts.push_back({ d, c, t });
+            out.verts.push_back({ b, c, t }); out.verts.push_back({ e, c, t }); out.verts.push_back({ d, c, t });
+        }
+    }
+    return true;
+}
+
+class ChunkStreamer {
+public:
+    ChunkStreamer() = default;
+    ChunkStreamer(const ChunkStreamer&) = delete;
+    ChunkStreamer& operator=(const ChunkStreamer&) = delete;
+    ~ChunkStreamer() { stop(); }
+
+    // radius: chunks kept around the focus chunk in each direction
+    bool open(const std::filesystem::path& directory, size_t budgetBytes, int radiusChunks) {
+        std::ifstream in(directory / "world.bin", std::ios::binary);
+        WorldFileHeader h;
+        if (!in.read((char*)&h, sizeof(h)) || std::string(h.magic, 4) != "LTWD" || h.version != 1 ||
+            h.chunkPx != kChunkPx || h.chunksX <= 0 || h.chunksY <= 0) {
+            std::cerr << "ERROR: couldn't read world " << (directory / "world.bin").string() << "\n";
+            return false;
+        }
+        dir = directory;
+        header = h;
+        budget = budgetBytes;
+        radius = std::max(1, radiusChunks);
+
+        quit = false;
+        loader = std::thread([this]() { loadLoop(); });
+        return true;
+    }
+
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(m);
+            quit = true;
+        }
+        cv.notify_all();
+        if (loader.joinable()) loader.join();
+    }
+
+    sf::Vector2f worldSize() const { return { header.width, header.height }; }
+
+    // game thread: recomputes the wanted set only when the focus crosses into another chunk
+    void setFocus(sf::Vector2f pos) {
+        sf::Vector2i c = chunkOf(pos);
+        if (c == focus && !wanted.empty()) return;
+        focus = c;
+
+        wanted.clear();
+        for (int y = c.y - radius; y <= c.y + radius; ++y)
+            for (int x = c.x - radius; x <= c.x + radius; ++x)
+                if (x >= 0 && y >= 0 && x < header.chunksX && y < header.chunksY) wanted.push_back({ x, y });
+        // nearest first, so the chunk under the player is read before the corners
+        std::sort(wanted.begin(), wanted.end(), [&](sf::Vector2i a, sf::Vector2i b) { return dist2(a) < dist2(b); });
+        queueDirty = true;
+    }
+
+    // game thread, once per frame, never blocks: hands new requests to the loader, adopts finished
+    // chunks and evicts over budget. True when the resident set changed.
+    bool poll() {
+        std::unique_lock<std::mutex> lock(m, std::try_to_lock);
+        if (!lock.owns_lock()) return false;
+
+        std::vector<std::unique_ptr<WorldChunk>> finished;
+        finished.swap(done);
+
+        if (queueDirty || !finished.empty()) {
+            queue.clear();
+            for (sf::Vector2i c : wanted) {
+                if (resident.count(key(c)) || (loading && *loading == c)) continue;
+                bool justLoaded = false;
+                for (auto& f : finished) if (f->coord == c) { justLoaded = true; break; }
+                if (!justLoaded) queue.push_back(c);
+            }
+            queueDirty = false;
+            if (!queue.empty()) cv.notify_one();
+        }
+        lock.unlock();
+
+        bool changed = false;
+        adopted.clear();
+        for (auto& f : finished) {
+            auto& slot = resident[key(f->coord)];
+            if (slot) continue; // a duplicate from a re-queued request
+            residentBytes += f->bytes();
+            adopted.push_back(f->coord);
+            slot = std::move(f);
+            changed = true;
+        }
+        changed |= evict();
+        return changed;
+    }
+
+    // chunks that became resident in the last poll() (wanted ones are never evicted, so inside
+    // focusBounds() this is the whole change)
+    const std::vector<sf::Vector2i>& justLoaded() const { return adopted; }
+
+    static sf::FloatRect chunkRect(sf::Vector2i c) {
+        return sf::FloatRect({ (float)(c.x * kChunkPx), (float)(c.y * kChunkPx) }, { (float)kChunkPx, (float)kChunkPx });
+    }
+
+    // load time / bench only: blocks until every wanted chunk is resident
+    void waitForFocus() {
+        for (;;) {
+            poll();
+            bool all = true;
+            for (sf::Vector2i c : wanted) if (!resident.count(key(c))) { all = false; break; }
+            if (all) return;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+    // the whole rect lies in resident chunks that loaded fine. Movement into the unknown waits
+    // for the loader, and a chunk that failed to load stays a solid block rather than a hole
+    bool isWalkable(const sf::FloatRect& r) const {
+        sf::Vector2i a = chunkOf(r.position), b = chunkOf(r.position + r.size);
+        for (int y = a.y; y <= b.y; ++y) {
+            for (int x = a.x; x <= b.x; ++x) {
+                auto it = resident.find(key({ x, y }));
+                if (it == resident.end() || it->second->failed) return false;
+            }
+        }
+        return true;
+    }
+
+    // world rect covered by the wanted chunks around the focus
+    sf::FloatRect focusBounds() const {
+        sf::Vector2i lo = { std::max(0, focus.x - radius), std::max(0, focus.y - radius) };
+        sf::Vector2i hi = { std::min(header.chunksX - 1, focus.x + radius), std::min(header.chunksY - 1, focus.y + radius) };
+        return sf::FloatRect({ (float)(lo.x * kChunkPx), (float)(lo.y * kChunkPx) },
+                             { (float)((hi.x - lo.x + 1) * kChunkPx), (float)((hi.y - lo.y + 1) * kChunkPx) });
+    }
+
+    void gather(std::vector<sf::FloatRect>& walls, std::vector<WorldTrigger>& triggers) const {
+        walls.clear();
+        triggers.clear();
+        for (auto& kv : resident) {
+            walls.insert(walls.end(), kv.second->walls.begin(), kv.second->walls.end());
+            triggers.insert(triggers.end(), kv.second->triggers.begin(), kv.second->triggers.end());
+        }
+    }
+
+    // tile layers of the resident chunks that overlap `visible`; returns draw calls issued
+    unsigned draw(sf::RenderTarget& target, const sf::FloatRect& visible) const {
+        unsigned calls = 0;
+        for (auto& kv : resident) {
+            const WorldChunk& c = *kv.second;
+            if (c.verts.empty() || !chunkRect(c.coord).findIntersection(visible)) continue;
+            target.draw(c.verts.data(), c.verts.size(), sf::PrimitiveType::Triangles);
+            ++calls;
+        }
+        return calls;
+    }
+
+    size_t residentCount() const { return resident.size(); }
+    size_t failedCount() const {
+        size_t n = 0;
+        for (auto& kv : resident) n += kv.second->failed ? 1 : 0;
+        return n;
+    }
+    size_t memoryUsed() const { return residentBytes; }
+
+private:
+    static long long key(sf::Vector2i c) { return (long long)(((unsigned long long)(unsigned)c.y << 32) | (unsigned)c.x); }
+
+    sf::Vector2i chunkOf(sf::Vector2f p) const {
+        return { (int)std::floor(p.x / kChunkPx), (int)std::floor(p.y / kChunkPx) };
+    }
+
+    int dist2(sf::Vector2i c) const {
+        return (c.x - focus.x) * (c.x - focus.x) + (c.y - focus.y) * (c.y - focus.y);
+    }
+
+    // farthest unwanted chunks go first; wanted ones are never evicted
+    bool evict() {
+        if (residentBytes <= budget) return false;
+
+        std::vector<std::pair<int, long long>> candidates;
+        for (auto& kv : resident) {
+            sf::Vector2i c = kv.second->coord;
+            bool isWanted = std::abs(c.x - focus.x) <= radius && std::abs(c.y - focus.y) <= radius;
+            if (!isWanted) candidates.push_back({ dist2(c), kv.first });
+        }
+        std::sort(candidates.begin(), candidates.end(), [](auto& a, auto& b) { return a.first > b.first; });
+
+        bool changed = false;
+        for (auto& cand : candidates) {
+            if (residentBytes <= budget) break;
+            auto it = resident.find(cand.second);
+            residentBytes -= it->second->bytes();
+            resident.erase(it);
+            changed = true;
+        }
+        if (residentBytes > budget && !warnedBudget) {
+            std::cerr << "WARNING: world chunks around the player alone exceed the memory budget\n";
+            warnedBudget = true;
+        }
+        return changed;
+    }
+
+    // loader thread
+    void loadLoop() {
+        std::unique_lock<std::mutex> lock(m);
+        for (;;) {
+            cv.wait(lock, [&]() { return quit || !queue.empty(); });
+            if (quit) return;
+
+            sf::Vector2i c = queue.front();
+            queue.pop_front();
+            loading = c;
+            lock.unlock();
+
+            auto chunk = std::make_unique<WorldChunk>();
+            if (!readChunk(chunkPath(dir, c), c, *chunk)) {
+                std::cerr << "ERROR: bad or missing world chunk " << chunkPath(dir, c).string() << "\n";
+                // still resident, so it isn't requested every frame, but nothing can enter it
+                *chunk = WorldChunk();
+                chunk->coord = c;
+                chunk->failed = true;
+            }
+
+            lock.lock();
+            loading.reset();
+            done.push_back(std::move(chunk));
+        }
+    }
+
+    std::filesystem::path dir;
+    WorldFileHeader header;
+    size_t budget = 0;
+    int radius = 1;
+
+    // game thread
+    sf::Vector2i focus{ 0, 0 };
+    std::vector<sf::Vector2i> wanted;
+    bool queueDirty = false;
+    std::unordered_map<long long, std::unique_ptr<WorldChunk>> resident;
+    std::vector<sf::Vector2i> adopted;
+    size_t residentBytes = 0;
+    bool warnedBudget = false;
+
+    // shared, guarded by m
+    std::mutex m;
+    std::condition_variable cv;
+    std::deque<sf::Vector2i> queue;
+    std::optional<sf::Vector2i> loading;
+    std::vector<std::unique_ptr<WorldChunk>> done;
+    bool quit = false;
+
+    std::thread loader;
+};
+
+// -----------------------------
+// Offline baker: rooms -> chunk files
+// -----------------------------
+// Lays out roomsX x roomsY copies of one room (room-local interior walls), each with 30px outer
+// walls that have a doorway toward every neighbor. `firstRoomTriggers` only go into room 0.
+static bool bakeWorld(const std::filesystem::path& dir, int roomsX, int roomsY, sf::Vector2f roomSize,
+                      const std::vector<sf::FloatRect>& interiorWalls, const std::vector<WorldTrigger>& firstRoomTriggers) {
+    roomsX = std::max(1, roomsX);
+    roomsY = std::max(1, roomsY);
+
+    const float t = 30.f;    // wall thickness
+    const float door = 120.f;
+    std::vector<sf::FloatRect> walls;
+
+    // a wall segment along one edge, split around a centered doorway when `open`
+    auto edge = [&](sf::FloatRect r, bool horizontal, bool open) {
+        if (!open) { walls.push_back(r); return; }
+        if (horizontal) {
+            float half = (r.size.x - door) / 2.f;
+            walls.push_back(sf::FloatRect(r.position, { half, r.size.y }));
+            walls.push_back(sf::FloatRect({ r.position.x + half + door, r.position.y }, { half, r.size.y }));
+        }
+        else {
+            float half = (r.size.y - door) / 2.f;
+            walls.push_back(sf::FloatRect(r.position, { r.size.x, half }));
+            walls.push_back(sf::FloatRect({ r.position.x, r.position.y + half + door }, { r.size.x, half }));
+        }
+    };
+
+    for (int ry = 0; ry < roomsY; ++ry) {
+        for (int rx = 0; rx < roomsX; ++rx) {
+            sf::Vector2f o = { rx * roomSize.x, ry * roomSize.y };
+            edge(sf::FloatRect(o, { roomSize.x, t }), true, ry > 0);
+            edge(sf::FloatRect({ o.x, o.y + roomSize.y - t }, { roomSize.x, t }), true, ry < roomsY - 1);
+            edge(sf::FloatRect(o, { t, roomSize.y }), false, rx > 0);
+            edge(sf::FloatRect({ o.x + roomSize.x - t, o.y }, { t, roomSize.y }), false, rx < roomsX - 1);
+            for (const sf::FloatRect& w : interiorWalls)
+                walls.push_back(sf::FloatRect(o + w.position, w.size));
+        }
+    }
+
+    WorldFileHeader wh;
+    wh.width = roomsX * roomSize.x;
+    wh.height = roomsY * roomSize.y;
+    wh.chunksX = (int)std::ceil(wh.width / kChunkPx);
+    wh.chunksY = (int)std::ceil(wh.height / kChunkPx);
+
+    std::error_code ec;
+    std::filesystem::create_directories(dir, ec);
+    {
+        std::ofstream out(dir / "world.bin", std::ios::binary | std::ios::trunc);
+        if (!out.write((const char*)&wh, sizeof(wh))) {
+            std::cerr << "ERROR: couldn't write " << (dir / "world.bin").string() << "\n";
+            return false;
+        }
+    }
+
+    for (int cy = 0; cy < wh.chunksY; ++cy) {
+        for (int cx = 0; cx < wh.chunksX; ++cx) {
+            const sf::FloatRect area({ (float)(cx * kChunkPx), (float)(cy * kChunkPx) }, { (float)kChunkPx, (float)kChunkPx });
+
+            std::vector<std::uint8_t> tiles((size_t)kChunkTiles * kChunkTiles, 0);
+            for (int ty = 0; ty < kChunkTiles; ++ty) {
+                for (int tx = 0; tx < kChunkTiles; ++tx) {
+                    float px = area.position.x + (tx + 0.5f) * kTilePx;
+                    float py = area.position.y + (ty + 0.5f) * kTilePx;
+                    if (px >= wh.width || py >= wh.height) continue;
+                    int gx = cx * kChunkTiles + tx, gy = cy * kChunkTiles + ty;
+                    tiles[(size_t)ty * kChunkTiles + tx] = ((gx * 7 + gy * 13) % 11 == 0) ? 2 : 1;
+                }
+            }
+
+            std::vector<ChunkRect> chunkWalls;
+            for (const sf::FloatRect& w : walls) {
+                if (auto clip = w.findIntersection(area))
+                    chunkWalls.push_back({ clip->position.x, clip->position.y, clip->size.x, clip->size.y });
+            }
+
+            std::vector<ChunkTriggerRecord> chunkTriggers;
+            for (const WorldTrigger& tr : firstRoomTriggers) {
+                if (area.contains(tr.rect.position + tr.rect.size / 2.f))
+                    chunkTriggers.push_back({ { tr.rect.position.x, tr.rect.position.y, tr.rect.size.x, tr.rect.size.y },
+                                              (std::uint32_t)tr.kind });
+            }
+
+            ChunkFileHeader ch;
+            ch.cx = cx;
+            ch.cy = cy;
+            ch.wallCount = (std::uint32_t)chunkWalls.size();
+            ch.triggerCount = (std::uint32_t)chunkTriggers.size();
+
+            std::filesystem::path path = chunkPath(dir, { cx, cy });
+            std::ofstream out(path, std::ios::binary | std::ios::trunc);
+            out.write((const char*)&ch, sizeof(ch));
+            out.write((const char*)tiles.data(), (std::streamsize)tiles.size());
+            out.write((const char*)chunkWalls.data(), (std::streamsize)(chunkWalls.size() * sizeof(ChunkRect)));
+            out.write((const char*)chunkTriggers.data(), (std::streamsize)(chunkTriggers.size() * sizeof(ChunkTriggerRecord)));
+            if (!out) {
+                std::cerr << "ERROR: couldn't write " << path.string() << "\n";
+                return false;
+            }
+        }
+    }
+
+    std::cout << "baked " << roomsX << "x" << roomsY << " rooms (" << wh.width << "x" << wh.height << " px) into "
+              << wh.chunksX * wh.chunksY << " chunks in " << dir.string() << "\n";
+    return true;
+}